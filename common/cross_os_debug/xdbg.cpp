@@ -4,7 +4,9 @@
  * Nothing in here should hold state, that should all be managed in Debugger.
  */
 
+#include <chrono>
 #include <cstring>
+#include <mutex>
 #include "common/goal_constants.h"
 #include "common/util/Timer.h"
 #include "third-party/fmt/core.h"
@@ -19,7 +21,11 @@
 #include <sys/types.h>
 #include <sys/user.h>
 #include <sys/wait.h>
+#include <sys/mman.h>
 #include <fcntl.h>
+#include <dirent.h>
+#include <pthread.h>
+#include <signal.h>
 #elif _WIN32
 
 #endif
@@ -84,6 +90,66 @@ bool attach_and_break(const ThreadID& tid) {
   }
 }
 
+namespace {
+/*!
+ * Fill out a SignalInfo for a thread that waitpid reported as stopped.
+ */
+void get_stop_info(int status, SignalInfo* out) {
+  if (!out) {
+    return;
+  }
+  switch (WSTOPSIG(status)) {
+    case SIGSEGV:
+      out->kind = SignalInfo::SEGFAULT;
+      break;
+    case SIGFPE:
+      out->kind = SignalInfo::MATH_EXCEPTION;
+      break;
+    case SIGTRAP:
+      out->kind = SignalInfo::BREAK;
+      break;
+
+    default:
+      out->kind = SignalInfo::UNKNOWN;
+  }
+}
+
+// Sent to a thread blocked in wait_for_stop to wake it up. The handler does nothing, but it is
+// installed without SA_RESTART, so waitpid gives up with EINTR.
+constexpr int WAIT_INTERRUPT_SIGNAL = SIGUSR2;
+
+void wait_interrupt_handler(int) {}
+
+/*!
+ * The runtime's sampling profiler interrupts the target with SIGPROF many times a second. These
+ * aren't stops the debugger cares about, so they are passed on to the target right away.
+ * Returns true if the stop was handled like this.
+ */
+bool pass_profiler_signal(const ThreadID& tid, int status) {
+  // signal-delivery-stops have no ptrace event in the high bits.
+  if ((status >> 16) != 0 || WSTOPSIG(status) != SIGPROF) {
+    return false;
+  }
+  if (ptrace(PTRACE_CONT, tid.id, nullptr, (void*)(uintptr_t)SIGPROF) < 0) {
+    printf("[Debugger] Failed to pass on SIGPROF: %s\n", strerror(errno));
+  }
+  return true;
+}
+
+void install_wait_interrupt_handler() {
+  static std::once_flag once;
+  std::call_once(once, [] {
+    struct sigaction action = {};
+    action.sa_handler = wait_interrupt_handler;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = 0;
+    if (sigaction(WAIT_INTERRUPT_SIGNAL, &action, nullptr) < 0) {
+      printf("[Debugger] Failed to install wait interrupt handler: %s\n", strerror(errno));
+    }
+  });
+}
+}  // namespace
+
 /*!
  * Has the given thread transitioned from running to stopped?
  * If the thread has transitioned to stop, check_stopped should only return true once.
@@ -99,44 +165,125 @@ bool check_stopped(const ThreadID& tid, SignalInfo* out) {
     return false;
   }
 
-  if (rv > 0) {
+  if (rv > 0 && WIFSTOPPED(status) && !pass_profiler_signal(tid, status)) {
     // status has actually changed
-    if (WIFSTOPPED(status)) {
-      auto sig = WSTOPSIG(status);
-      if (out) {
-        switch (sig) {
-          case SIGSEGV:
-            out->kind = SignalInfo::SEGFAULT;
-            break;
-          case SIGFPE:
-            out->kind = SignalInfo::MATH_EXCEPTION;
-            break;
-          case SIGTRAP:
-            out->kind = SignalInfo::BREAK;
-            break;
-
-          default:
-            out->kind = SignalInfo::UNKNOWN;
-        }
-      }
-      return true;
+    get_stop_info(status, out);
+    return true;
+  }
+
+  return false;
+}
+
+/*!
+ * Wait until the given thread stops. Like check_stopped, but blocks instead of polling.
+ * Returns false without a stop if interrupt_wait is used on the waiting thread, or if the thread
+ * can't be waited on anymore.
+ */
+bool wait_for_stop(const ThreadID& tid, SignalInfo* out) {
+  install_wait_interrupt_handler();
+  int status;
+  int rv;
+  do {
+    rv = waitpid(tid.id, &status, 0);
+  } while (rv > 0 && WIFSTOPPED(status) && pass_profiler_signal(tid, status));
+  if (rv < 0) {
+    if (errno != EINTR) {
+      printf("[Debugger] Failed to waitpid: %s.\n", strerror(errno));
+      // the thread is probably gone. Don't let callers that loop on this spin.
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
     }
+    return false;
   }
 
+  if (WIFSTOPPED(status)) {
+    get_stop_info(status, out);
+    return true;
+  }
   return false;
 }
 
+/*!
+ * Wake up a thread that is blocked in wait_for_stop. If the thread isn't in wait_for_stop yet, this
+ * does nothing, so the caller should keep trying until the waiter notices.
+ */
+void interrupt_wait(std::thread& waiter) {
+  install_wait_interrupt_handler();
+  pthread_kill(waiter.native_handle(), WAIT_INTERRUPT_SIGNAL);
+}
+
+/*!
+ * Find a memfd the target created with the given name and map size bytes of it into our address
+ * space. Threads share the fd table, so we can look in /proc/tid/fd for it.
+ * Returns nullptr if the target doesn't have it. Unmap with unmap_shared_buffer.
+ */
+u8* map_shared_buffer(const ThreadID& tid, const char* name, size_t size) {
+  auto fd_dir = fmt::format("/proc/{}/fd", tid.id);
+  auto expected_link = fmt::format("/memfd:{}", name);
+  DIR* dir = opendir(fd_dir.c_str());
+  if (!dir) {
+    return nullptr;
+  }
+
+  u8* result = nullptr;
+  char link[256];
+  while (auto entry = readdir(dir)) {
+    auto path = fmt::format("{}/{}", fd_dir, entry->d_name);
+    auto len = readlink(path.c_str(), link, sizeof(link) - 1);
+    if (len < 0) {
+      continue;
+    }
+    link[len] = '\0';
+    // the link is followed by " (deleted)", as a memfd has no real file.
+    if (strncmp(link, expected_link.c_str(), expected_link.length()) != 0) {
+      continue;
+    }
+
+    int fd = open(path.c_str(), O_RDWR);
+    if (fd < 0) {
+      printf("[Debugger] Failed to open shared memory: %s.\n", strerror(errno));
+      break;
+    }
+    auto mem = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);  // the mapping keeps it alive.
+    if (mem == MAP_FAILED) {
+      printf("[Debugger] Failed to map shared memory: %s.\n", strerror(errno));
+      break;
+    }
+    result = (u8*)mem;
+    break;
+  }
+  closedir(dir);
+  return result;
+}
+
+void unmap_shared_buffer(u8* mem, size_t size) {
+  munmap(mem, size);
+}
+
+namespace {
+/*!
+ * Can this access be done with the shared memory? Memory below EE_MAIN_MEM_LOW_PROTECT is not
+ * accessible in the target, so we don't allow it here either.
+ */
+bool in_shared_memory(const MemoryHandle& mem, int size, u32 goal_addr) {
+  return mem.shared && goal_addr >= (u32)EE_MAIN_MEM_LOW_PROTECT &&
+         (u64)goal_addr + size <= (u64)EE_MAIN_MEM_SIZE;
+}
+}  // namespace
+
 /*!
  * Open memory of target. Assumes we are already connected and halted.
  * If successful returns true and populates out with a "handle" to the memory.
+ * If the target shares its EE memory, it is also mapped so it can be accessed without syscalls.
  */
 bool open_memory(const ThreadID& tid, MemoryHandle* out) {
   int fd = open(fmt::format("/proc/{}/mem", tid.id).c_str(), O_RDWR);
-  if (fd < -1) {
+  if (fd < 0) {
     printf("[Debugger] Failed to open memory: %s.\n", strerror(errno));
     return false;
   }
   out->fd = fd;
+  out->shared = map_shared_buffer(tid, EE_MAIN_MEM_SHARED_NAME, EE_MAIN_MEM_SIZE);
   return true;
 }
 
@@ -145,13 +292,25 @@ bool open_memory(const ThreadID& tid, MemoryHandle* out) {
  */
 bool close_memory(const ThreadID& tid, MemoryHandle* handle) {
   (void)tid;
+  if (handle->shared) {
+    unmap_shared_buffer(handle->shared, EE_MAIN_MEM_SIZE);
+    handle->shared = nullptr;
+  }
   if (close(handle->fd) < 0) {
     printf("[Debugger] Failed to close memory: %s.\n", strerror(errno));
     return false;
   }
+  handle->fd = -1;
   return true;
 }
 
+/*!
+ * Is the target's EE memory mapped directly? If so, it can be accessed while the target runs.
+ */
+bool is_memory_shared(const MemoryHandle& mem) {
+  return mem.shared;
+}
+
 /*!
  * Read data from target's EE memory
  */
@@ -160,6 +319,10 @@ bool read_goal_memory(u8* dest_buffer,
                       u32 goal_addr,
                       const DebugContext& context,
                       const MemoryHandle& mem) {
+  if (in_shared_memory(mem, size, goal_addr)) {
+    memcpy(dest_buffer, mem.shared + goal_addr, size);
+    return true;
+  }
   if (pread(mem.fd, dest_buffer, size, context.base + goal_addr) != size) {
     printf("[Debugger] Failed to read memory: %s.\n", strerror(errno));
     return false;
@@ -175,6 +338,10 @@ bool write_goal_memory(const u8* src_buffer,
                        u32 goal_addr,
                        const DebugContext& context,
                        const MemoryHandle& mem) {
+  if (in_shared_memory(mem, size, goal_addr)) {
+    memcpy(mem.shared + goal_addr, src_buffer, size);
+    return true;
+  }
   if (pwrite(mem.fd, src_buffer, size, context.base + goal_addr) != size) {
     printf("[Debugger] Failed to write memory: %s.\n", strerror(errno));
     return false;
@@ -335,6 +502,16 @@ bool close_memory(const ThreadID& tid, MemoryHandle* handle) {
   return false;
 }
 
+bool is_memory_shared(const MemoryHandle& mem) {
+  return false;
+}
+
+u8* map_shared_buffer(const ThreadID& tid, const char* name, size_t size) {
+  return nullptr;
+}
+
+void unmap_shared_buffer(u8* mem, size_t size) {}
+
 bool read_goal_memory(u8* dest_buffer,
                       int size,
                       u32 goal_addr,
@@ -355,6 +532,13 @@ bool check_stopped(const ThreadID& tid, SignalInfo* out) {
   return false;
 }
 
+bool wait_for_stop(const ThreadID& tid, SignalInfo* out) {
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  return false;
+}
+
+void interrupt_wait(std::thread& waiter) {}
+
 bool set_regs_now(const ThreadID& tid, const Regs& out) {
   return false;
 }
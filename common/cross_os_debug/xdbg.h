@@ -8,6 +8,7 @@
 
 #include <string>
 #include <cstdint>
+#include <thread>
 #include "common/common_types.h"
 
 #ifdef __linux
@@ -33,9 +34,11 @@ struct ThreadID {
 
 /*!
  * Handle for the memory of a process.
+ * If the target shares its EE memory, shared points to our own mapping of it.
  */
 struct MemoryHandle {
-  int fd;
+  int fd = -1;
+  u8* shared = nullptr;
 };
 
 #elif _WIN32
@@ -98,6 +101,9 @@ bool break_now(const ThreadID& tid);
 bool cont_now(const ThreadID& tid);
 bool open_memory(const ThreadID& tid, MemoryHandle* out);
 bool close_memory(const ThreadID& tid, MemoryHandle* handle);
+bool is_memory_shared(const MemoryHandle& mem);
+u8* map_shared_buffer(const ThreadID& tid, const char* name, size_t size);
+void unmap_shared_buffer(u8* mem, size_t size);
 bool read_goal_memory(u8* dest_buffer,
                       int size,
                       u32 goal_addr,
@@ -119,5 +125,7 @@ bool write_goal_value(T& value,
 }
 
 bool check_stopped(const ThreadID& tid, SignalInfo* out);
+bool wait_for_stop(const ThreadID& tid, SignalInfo* out);
+void interrupt_wait(std::thread& waiter);
 
 }  // namespace xdbg
@@ -36,4 +36,9 @@ constexpr u64 EE_MAIN_MEM_MAP = 0x2123000000;      // intentionally > 32-bit to
 // so this should be used only for debugging.
 constexpr bool EE_MEM_LOW_MAP = false;
 
+// when true, the runtime backs the EE memory with a named memfd on Linux. The debugger finds it
+// through /proc and maps it directly, instead of reading and writing through /proc/pid/mem.
+constexpr bool EE_MEM_SHARED = true;
+constexpr const char* EE_MAIN_MEM_SHARED_NAME = "opengoal-ee-main-mem";
+
 #endif  // JAK_GOAL_CONSTANTS_H
@@ -124,7 +124,7 @@ std::string fixed_to_string(char x) {
 /*!
  * Create a new symbol object by interning
  */
-Object SymbolObject::make_new(SymbolTable& st, const std::string& name) {
+Object SymbolObject::make_new(SymbolTable& st, std::string_view name) {
   Object obj;
   obj.type = ObjectType::SYMBOL;
   obj.heap_obj = st.intern(name);
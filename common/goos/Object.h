@@ -41,6 +41,7 @@
  */
 
 #include <string>
+#include <string_view>
 #include <cassert>
 #include <memory>
 #include <unordered_map>
@@ -148,6 +149,8 @@ class HeapObject {
   virtual ~HeapObject() = default;
 };
 
+class SourceText;
+
 // forward declare all HeapObjects
 class PairObject;
 class EnvironmentObject;
@@ -367,7 +370,7 @@ class SymbolObject : public HeapObject {
  public:
   std::string name;
   explicit SymbolObject(std::string _name) : name(std::move(_name)) {}
-  static Object make_new(SymbolTable& st, const std::string& name);
+  static Object make_new(SymbolTable& st, std::string_view name);
 
   std::string print() const override { return name; }
 
@@ -381,10 +384,12 @@ class SymbolObject : public HeapObject {
  */
 class SymbolTable {
  public:
-  std::shared_ptr<SymbolObject> intern(const std::string& name) {
+  std::shared_ptr<SymbolObject> intern(std::string_view name) {
     auto kv = table.find(name);
     if (kv == table.end()) {
-      auto iter = table.insert({name, std::make_shared<SymbolObject>(name)});
+      auto sym = std::make_shared<SymbolObject>(std::string(name));
+      // the key is a view of the name stored in the symbol, which never moves or changes.
+      auto iter = table.insert({sym->name, sym});
       return (*iter.first).second;
     } else {
       return kv->second;
@@ -394,7 +399,7 @@ class SymbolTable {
   ~SymbolTable() = default;
 
  private:
-  std::unordered_map<std::string, std::shared_ptr<SymbolObject>> table;
+  std::unordered_map<std::string_view, std::shared_ptr<SymbolObject>> table;
 };
 
 class StringObject : public HeapObject {
@@ -420,6 +425,11 @@ class PairObject : public HeapObject {
  public:
   Object car, cdr;
 
+  // where this pair was read from, set by TextDb::link. Null if unknown. The text is freed once
+  // no pairs read from it are left.
+  std::shared_ptr<SourceText> source;
+  s32 source_offset = 0;
+
   PairObject(Object car_, Object cdr_) : car(car_), cdr(cdr_) {}
 
   static Object make_new(Object a, Object b) {
@@ -5,6 +5,7 @@
  */
 
 #include <cassert>
+#include <mutex>
 #include <stdexcept>
 #include <utility>
 #include "PrettyPrinter.h"
@@ -557,6 +558,9 @@ goos::Reader& get_pretty_printer_reader() {
 }
 
 goos::Object to_symbol(const std::string& str) {
+  // the decompiler builds forms from multiple threads, so interning must be locked.
+  static std::mutex symbol_table_mutex;
+  std::lock_guard<std::mutex> lock(symbol_table_mutex);
   return goos::SymbolObject::make_new(pretty_printer_reader.symbolTable, str);
 }
 
@@ -9,6 +9,7 @@
  * launching the compiler or the compiler test.
  */
 
+#include <charconv>
 #include "Reader.h"
 #include "third-party/linenoise.h"
 #include "common/util/FileUtil.h"
@@ -17,20 +18,6 @@
 namespace goos {
 
 namespace {
-/*!
- * Is this a valid character to start a decimal integer number?
- */
-bool decimal_start(char c) {
-  return (c >= '0' && c <= '9') || c == '-';
-}
-
-/*!
- * Is this a valid character to start a floating point number?
- */
-bool float_start(char c) {
-  return (c >= '0' && c <= '9') || c == '-' || c == '.';
-}
-
 /*!
  * Is this a valid character for a hex number?
  */
@@ -38,17 +25,44 @@ bool hex_char(char c) {
   return !((c < '0' || c > '9') && (c < 'a' || c > 'f') && (c < 'A' || c > 'F'));
 }
 
-/*!
- * Does the given string contain c?
- */
-bool str_contains(const std::string& str, char c) {
-  for (auto& x : str) {
-    if (x == c) {
-      return true;
+// character classes, used to classify tokens as they are scanned.
+enum CharClass : u8 {
+  CC_DIGIT = 1,         // 0-9
+  CC_TOKEN_END = 2,     // ends a token, if it isn't the first character
+  CC_SYMBOL_START = 4,  // can be the first character of a symbol
+};
+
+struct CharClassTable {
+  u8 classes[256] = {0};
+
+  CharClassTable() {
+    for (char x = 'a'; x <= 'z'; x++) {
+      classes[(u8)x] |= CC_SYMBOL_START;
+    }
+
+    for (char x = 'A'; x <= 'Z'; x++) {
+      classes[(u8)x] |= CC_SYMBOL_START;
+    }
+
+    for (char x = '0'; x <= '9'; x++) {
+      classes[(u8)x] |= CC_SYMBOL_START | CC_DIGIT;
+    }
+
+    const char bonus[] = "!$%&*+-/\\.,@^_-;:<>?~=#";
+    for (const char* c = bonus; *c; c++) {
+      classes[(u8)*c] |= CC_SYMBOL_START;
+    }
+
+    const char token_end[] = " \n\t);#(";
+    for (const char* c = token_end; *c; c++) {
+      classes[(u8)*c] |= CC_TOKEN_END;
     }
   }
-  return false;
-}
+
+  u8 operator[](char c) const { return classes[(u8)c]; }
+};
+
+const CharClassTable char_classes;
 }  // namespace
 
 /*!
@@ -110,29 +124,6 @@ Reader::Reader() {
   add_reader_macro("`", "quasiquote");
   add_reader_macro(",", "unquote");
   add_reader_macro(",@", "unquote-splicing");
-
-  // setup table of which characters are valid for starting a symbol
-  for (auto& x : valid_symbols_chars) {
-    x = false;
-  }
-
-  for (char x = 'a'; x <= 'z'; x++) {
-    valid_symbols_chars[(int)x] = true;
-  }
-
-  for (char x = 'A'; x <= 'Z'; x++) {
-    valid_symbols_chars[(int)x] = true;
-  }
-
-  for (char x = '0'; x <= '9'; x++) {
-    valid_symbols_chars[(int)x] = true;
-  }
-
-  const char bonus[] = "!$%&*+-/\\.,@^_-;:<>?~=#";
-
-  for (const char* c = bonus; *c; c++) {
-    valid_symbols_chars[(int)*c] = true;
-  }
 }
 
 /*!
@@ -146,9 +137,8 @@ Object Reader::read_from_stdin(const std::string& prompt_name) {
   linenoise::AddHistory(line.c_str());
   // todo, decide if we should keep reading or not.
 
-  // create text fragment and add to the DB
+  // create text fragment
   auto textFrag = std::make_shared<ReplText>(line);
-  db.insert(textFrag);
 
   // perform read
   auto result = internal_read(textFrag);
@@ -160,9 +150,8 @@ Object Reader::read_from_stdin(const std::string& prompt_name) {
  * Read a string.
  */
 Object Reader::read_from_string(const std::string& str, bool add_top_level) {
-  // create text fragment and add to the DB
+  // create text fragment
   auto textFrag = std::make_shared<ProgramString>(str);
-  db.insert(textFrag);
 
   // perform read
   auto result = internal_read(textFrag, add_top_level);
@@ -175,7 +164,6 @@ Object Reader::read_from_string(const std::string& str, bool add_top_level) {
  */
 Object Reader::read_from_file(const std::vector<std::string>& file_path) {
   auto textFrag = std::make_shared<FileText>(file_util::get_file_path(file_path));
-  db.insert(textFrag);
 
   auto result = internal_read(textFrag);
   db.link(result, textFrag, 0);
@@ -187,7 +175,7 @@ Object Reader::read_from_file(const std::vector<std::string>& file_path) {
  */
 Object Reader::internal_read(std::shared_ptr<SourceText> text, bool add_top_level) {
   // first create stream
-  TextStream ts(text);
+  TextStream ts(std::move(text));
 
   // clean up first whitespace
   ts.seek_past_whitespace_and_comments();
@@ -204,45 +192,91 @@ Object Reader::internal_read(std::shared_ptr<SourceText> text, bool add_top_leve
 /*!
  * Given a stream starting at the first character of a token, get the token. Doesn't consume
  * whitespace at the end and leaves the stream on the first character after the token.
+ * The token is classified as it is scanned, and its text points into the stream's SourceText.
  */
 Token Reader::get_next_token(TextStream& stream) {
   assert(stream.text_remains());
   Token t;
   t.source_line = stream.line_count;
   t.source_offset = stream.seek;
-  t.source_text = stream.text;
+  const char* start = stream.text->get_text() + stream.seek;
 
   char first = stream.read();
-  t.text.push_back(first);
 
   // First - look for special tokens which end early:
-
-  // parens, double quotes, quotes, and backticks are tokens.
-  if (first == '(' || first == ')' || first == '"' || first == '\'' || first == '`')
-    return t;
-
-  // ",@" is its own token
-  if (first == ',' && stream.text_remains() && stream.peek() == '@') {
-    t.text.push_back(stream.read());
-    return t;
-  } else if (first == ',') {
-    // "," is its own token.
-    return t;
-  } else if (first == '#' && stream.text_remains() && stream.peek() == '(') {
-    t.text.push_back(stream.read());
-    return t;
+  switch (first) {
+    // parens, double quotes, quotes, and backticks are tokens.
+    case '(':
+      t.kind = TokenKind::OPEN_PAREN;
+      t.text = std::string_view(start, 1);
+      return t;
+    case ')':
+      t.kind = TokenKind::CLOSE_PAREN;
+      t.text = std::string_view(start, 1);
+      return t;
+    case '"':
+      t.kind = TokenKind::STRING_START;
+      t.text = std::string_view(start, 1);
+      return t;
+    case '\'':
+    case '`':
+      t.kind = TokenKind::READER_MACRO;
+      t.text = std::string_view(start, 1);
+      return t;
+    case ',':
+      // ",@" and "," are both tokens.
+      t.kind = TokenKind::READER_MACRO;
+      if (stream.text_remains() && stream.peek() == '@') {
+        stream.read();
+        t.text = std::string_view(start, 2);
+      } else {
+        t.text = std::string_view(start, 1);
+      }
+      return t;
+    case '#':
+      if (stream.text_remains() && stream.peek() == '(') {
+        stream.read();
+        t.kind = TokenKind::OPEN_ARRAY;
+        t.text = std::string_view(start, 2);
+        return t;
+      }
+      break;
+    default:
+      break;
   }
 
   // Second - not a special token, so we read until we get a character that ends the token.
+  // Along the way, keep track of whether it could be a decimal number.
+  bool could_be_number = (char_classes[first] & CC_DIGIT) || first == '-' || first == '.';
+  int dot_count = first == '.' ? 1 : 0;
+  int digit_count = (char_classes[first] & CC_DIGIT) ? 1 : 0;
   while (stream.text_remains()) {
     char next = stream.peek();
-    if (next == ' ' || next == '\n' || next == '\t' || next == ')' || next == ';' || next == '#' ||
-        next == '(') {
-      return t;
+    auto cls = char_classes[next];
+    if (cls & CC_TOKEN_END) {
+      break;
+    }
+
+    if (cls & CC_DIGIT) {
+      digit_count++;
+    } else if (next == '.') {
+      dot_count++;
     } else {
-      // not the end, so add to token.
-      t.text.push_back(stream.read());
+      could_be_number = false;
     }
+    stream.read();
+  }
+
+  t.text = std::string_view(start, stream.seek - t.source_offset);
+
+  if (first == '#') {
+    t.kind = TokenKind::HASH;
+  } else if (could_be_number && dot_count > 0) {
+    t.kind = TokenKind::FLOAT;
+  } else if (could_be_number && digit_count > 0) {
+    t.kind = TokenKind::INTEGER;
+  } else {
+    t.kind = TokenKind::SYMBOL;
   }
 
   return t;
@@ -262,46 +296,32 @@ void Reader::add_reader_macro(const std::string& shortcut, std::string replaceme
  */
 bool Reader::read_object(Token& tok, TextStream& ts, Object& obj) {
   try {
-    // try as integer
-    if (try_token_as_integer(tok, obj)) {
-      return true;
-    }
-
-    // try as hex
-    if (try_token_as_hex(tok, obj)) {
-      return true;
-    }
-
-    // try as binary
-    if (try_token_as_binary(tok, obj)) {
-      return true;
-    }
-
-    // try as float
-    if (try_token_as_float(tok, obj)) {
-      return true;
-    }
-
-    // try as string
-    if (tok.text[0] == '"') {
-      // it's a string.
-      assert(tok.text.length() == 1);
-      if (read_string(ts, obj)) {
-        return true;
-      } else {
-        throw_reader_error(ts, "failed to read string, close quote not found", -1);
-        return false;
-      }
-    }
-
-    if (tok.text[0] == '#' && tok.text.size() >= 2 && tok.text[1] == '(') {
-      if (read_array(ts, obj)) {
-        return true;
-      }
-    }
-
-    if (try_token_as_char(tok, obj)) {
-      return true;
+    switch (tok.kind) {
+      case TokenKind::INTEGER:
+        return try_token_as_integer(tok, obj);
+      case TokenKind::FLOAT:
+        // things like 1.2.3 look like a float, but are actually symbols.
+        if (try_token_as_float(tok, obj)) {
+          return true;
+        }
+        break;
+      case TokenKind::STRING_START:
+        if (read_string(ts, obj)) {
+          return true;
+        } else {
+          throw_reader_error(ts, "failed to read string, close quote not found", -1);
+          return false;
+        }
+      case TokenKind::OPEN_ARRAY:
+        return read_array(ts, obj);
+      case TokenKind::HASH:
+        if (try_token_as_hex(tok, obj) || try_token_as_binary(tok, obj) ||
+            try_token_as_char(tok, obj)) {
+          return true;
+        }
+        break;
+      default:
+        break;
     }
 
     // try as symbol
@@ -309,7 +329,7 @@ bool Reader::read_object(Token& tok, TextStream& ts, Object& obj) {
       return true;
     }
   } catch (std::exception& e) {
-    throw_reader_error(ts, "parsing token " + tok.text + " failed: " + e.what(), -1);
+    throw_reader_error(ts, "parsing token " + std::string(tok.text) + " failed: " + e.what(), -1);
   }
 
   return false;
@@ -323,15 +343,12 @@ bool Reader::read_array(TextStream& stream, Object& o) {
   bool got_close_paren = false;
   while (stream.text_remains()) {
     auto tok = get_next_token(stream);
-    assert(!tok.text.empty());
 
-    if (tok.text[0] == '(') {
-      assert(tok.text.length() == 1);
+    if (tok.kind == TokenKind::OPEN_PAREN) {
       objects.push_back(read_list(stream, true));
       stream.seek_past_whitespace_and_comments();
       continue;
-    } else if (tok.text[0] == ')') {
-      assert(tok.text.length() == 1);
+    } else if (tok.kind == TokenKind::CLOSE_PAREN) {
       got_close_paren = true;
       break;
     } else {
@@ -340,7 +357,8 @@ bool Reader::read_array(TextStream& stream, Object& o) {
         stream.seek_past_whitespace_and_comments();
         objects.push_back(next_obj);
       } else {
-        throw_reader_error(stream, "invalid token encountered in array reader: " + tok.text,
+        throw_reader_error(stream,
+                           "invalid token encountered in array reader: " + std::string(tok.text),
                            -int(tok.text.size()));
       }
     }
@@ -375,7 +393,8 @@ Object Reader::read_list(TextStream& ts, bool expect_close_paren) {
     bool got_reader_macro = false;
 
     std::string reader_macro_string;
-    auto kv = reader_macros.find(tok.text);
+    auto kv = tok.kind == TokenKind::READER_MACRO ? reader_macros.find(std::string(tok.text))
+                                                  : reader_macros.end();
     if (kv != reader_macros.end()) {
       // we found a reader macro! Remember this, and get the next token.
       got_reader_macro = true;
@@ -417,20 +436,14 @@ Object Reader::read_list(TextStream& ts, bool expect_close_paren) {
       }
     };
 
-    if (tok.text.empty()) {
-      assert(false);
-      // empty list
-      break;
-    } else if (tok.text[0] == '(') {
+    if (tok.kind == TokenKind::OPEN_PAREN) {
       // nested list
-      assert(tok.text.length() == 1);
       insert_object(read_list(ts, true));
       ts.seek_past_whitespace_and_comments();
       continue;
-    } else if (tok.text[0] == ')') {
+    } else if (tok.kind == TokenKind::CLOSE_PAREN) {
       // end of this list
       got_close_paren = true;
-      assert(tok.text.length() == 1);
       break;
     } else {
       // try to get an object
@@ -440,7 +453,7 @@ Object Reader::read_list(TextStream& ts, bool expect_close_paren) {
         ts.seek_past_whitespace_and_comments();
         insert_object(obj);
       } else {
-        throw_reader_error(ts, "invalid token encountered in reader: " + tok.text,
+        throw_reader_error(ts, "invalid token encountered in reader: " + std::string(tok.text),
                            -int(tok.text.size()));
       }
     }
@@ -492,8 +505,7 @@ Object Reader::read_list(TextStream& ts, bool expect_close_paren) {
 bool Reader::try_token_as_symbol(const Token& tok, Object& obj) {
   // check start character is valid:
   assert(!tok.text.empty());
-  char start = tok.text[0];
-  if (valid_symbols_chars[(int)start]) {
+  if (char_classes[tok.text[0]] & CC_SYMBOL_START) {
     obj = SymbolObject::make_new(symbolTable, tok.text);
     return true;
   } else {
@@ -567,29 +579,21 @@ bool Reader::read_string(TextStream& stream, Object& obj) {
  * Try decoding as a float.  Must have a "." in it.
  * Otherwise all combinations of leading zeros, "."'s, negative signs, etc are ok.
  * Trailing zeros not required.
+ * The token must be a FLOAT token.
  */
 bool Reader::try_token_as_float(const Token& tok, Object& obj) {
-  if (float_start(tok.text[0]) && str_contains(tok.text, '.')) {
-    size_t offset = tok.text[0] == '-' ? 1 : 0;
-    for (; offset < tok.text.size(); offset++) {
-      char c = tok.text.at(offset);
-      if ((c < '0' || c > '9') && (c != '.')) {
-        return false;
-      }
-    }
-
-    try {
-      std::size_t end = 0;
-      double v = std::stod(tok.text, &end);
-      if (end != tok.text.size())
-        return false;
-      obj = Object::make_float(v);
-      return true;
-    } catch (std::exception& e) {
+  assert(tok.kind == TokenKind::FLOAT);
+  try {
+    std::string text(tok.text);
+    std::size_t end = 0;
+    double v = std::stod(text, &end);
+    if (end != text.size())
       return false;
-    }
+    obj = Object::make_float(v);
+    return true;
+  } catch (std::exception& e) {
+    return false;
   }
-  return false;
 }
 
 /*!
@@ -599,7 +603,7 @@ bool Reader::try_token_as_float(const Token& tok, Object& obj) {
 bool Reader::try_token_as_binary(const Token& tok, Object& obj) {
   if (tok.text.size() >= 3 && tok.text[0] == '#' && tok.text[1] == 'b') {
     for (size_t offset = 2; offset < tok.text.size(); offset++) {
-      char c = tok.text.at(offset);
+      char c = tok.text[offset];
       if (c != '0' && c != '1') {
         return false;
       }
@@ -609,7 +613,7 @@ bool Reader::try_token_as_binary(const Token& tok, Object& obj) {
 
     for (uint32_t i = 2; i < tok.text.size(); i++) {
       if (value & (0x8000000000000000)) {
-        throw std::runtime_error("overflow in binary constant: " + tok.text);
+        throw std::runtime_error("overflow in binary constant: " + std::string(tok.text));
       }
 
       value <<= 1u;
@@ -631,26 +635,23 @@ bool Reader::try_token_as_binary(const Token& tok, Object& obj) {
  */
 bool Reader::try_token_as_hex(const Token& tok, Object& obj) {
   if (tok.text.size() >= 3 && tok.text[0] == '#' && tok.text[1] == 'x') {
-    // determine if we look like a number or not. If we look like a number, but stoll fails,
-    // it means that the number is too big or too small, and we should error
+    // determine if we look like a number or not. If we look like a number, but the conversion
+    // fails, it means that the number is too big or too small, and we should error
     for (size_t offset = 2; offset < tok.text.size(); offset++) {
-      char c = tok.text.at(offset);
-      if (!hex_char(c)) {
+      if (!hex_char(tok.text[offset])) {
         return false;
       }
     }
 
     uint64_t v = 0;
-    try {
-      std::size_t end = 0;
-      v = std::stoull(tok.text.substr(2), &end, 16);
-      if (end + 2 != tok.text.size())
-        return false;
-      obj = Object::make_integer(v);
-      return true;
-    } catch (std::exception& e) {
-      throw std::runtime_error("The number " + tok.text + " cannot be a hexadecimal constant");
+    auto end = tok.text.data() + tok.text.size();
+    auto result = std::from_chars(tok.text.data() + 2, end, v, 16);
+    if (result.ec != std::errc() || result.ptr != end) {
+      throw std::runtime_error("The number " + std::string(tok.text) +
+                               " cannot be a hexadecimal constant");
     }
+    obj = Object::make_integer(v);
+    return true;
   }
   return false;
 }
@@ -658,35 +659,21 @@ bool Reader::try_token_as_hex(const Token& tok, Object& obj) {
 /*!
  * Try decoding as integer. No decimals points allowed.
  * 64-bit signed. Won't accept values between INT64_MAX and UINT64_MAX.
+ * The token must be an INTEGER token.
  */
 bool Reader::try_token_as_integer(const Token& tok, Object& obj) {
-  if (decimal_start(tok.text[0]) && !str_contains(tok.text, '.')) {
-    // determine if we look like a number or not. If we look like a number, but stoll fails,
-    // it means that the number is too big or too small, and we should error
-    size_t offset = tok.text[0] == '-' ? 1 : 0;
-    if (offset == 1 && tok.text.size() == 1) {
-      return false;  // - by itself is not a number!
-    }
-    for (; offset < tok.text.size(); offset++) {
-      char c = tok.text.at(offset);
-      if (c < '0' || c > '9') {
-        return false;
-      }
-    }
-    uint64_t v = 0;
-    try {
-      std::size_t end = 0;
-      v = std::stoll(tok.text, &end);
-      if (end != tok.text.size()) {
-        return false;
-      }
-      obj = Object::make_integer(v);
-      return true;
-    } catch (std::exception& e) {
-      throw std::runtime_error("The number " + tok.text + " cannot be an integer constant");
-    }
+  assert(tok.kind == TokenKind::INTEGER);
+  // the token looks like a number. If the conversion fails, it means that the number is too big
+  // or too small, and we should error
+  int64_t v = 0;
+  auto end = tok.text.data() + tok.text.size();
+  auto result = std::from_chars(tok.text.data(), end, v);
+  if (result.ec != std::errc() || result.ptr != end) {
+    throw std::runtime_error("The number " + std::string(tok.text) +
+                             " cannot be an integer constant");
   }
-  return false;
+  obj = Object::make_integer(v);
+  return true;
 }
 
 bool Reader::try_token_as_char(const Token& tok, Object& obj) {
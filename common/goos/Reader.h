@@ -13,6 +13,7 @@
 
 #include <memory>
 #include <cassert>
+#include <string_view>
 #include <utility>
 #include <unordered_map>
 
@@ -25,7 +26,7 @@ namespace goos {
  * Wrapper around a source of text that allows reading/peeking.
  */
 struct TextStream {
-  explicit TextStream(std::shared_ptr<SourceText> ptr) { text = std::move(ptr); }
+  explicit TextStream(std::shared_ptr<SourceText> ptr) : text(std::move(ptr)) {}
 
   std::shared_ptr<SourceText> text;
   int seek = 0;
@@ -54,14 +55,31 @@ struct TextStream {
   void seek_past_whitespace_and_comments();
 };
 
+/*!
+ * What a token looks like. This is figured out while the token is scanned, so the reader only
+ * needs to try the conversions that could possibly work.
+ */
+enum class TokenKind {
+  OPEN_PAREN,    // (
+  CLOSE_PAREN,   // )
+  OPEN_ARRAY,    // #(
+  STRING_START,  // "
+  READER_MACRO,  // ' ` , ,@
+  INTEGER,       // decimal digits, with an optional leading -
+  FLOAT,         // decimal digits with at least one ., with an optional leading -
+  HASH,          // starts with #. Could be hex, binary, char, or a symbol
+  SYMBOL         // anything else
+};
+
 /*!
  * A Token used for parsing.
+ * The text is a view into the SourceText of the TextStream it was read from.
  */
 struct Token {
-  std::shared_ptr<SourceText> source_text;
+  TokenKind kind;
   int source_offset;
   int source_line;
-  std::string text;
+  std::string_view text;
 };
 
 class Reader {
@@ -94,8 +112,6 @@ class Reader {
   bool read_string(TextStream& stream, Object& obj);
   void add_reader_macro(const std::string& shortcut, std::string replacement);
 
-  char valid_symbols_chars[256];
-
   std::unordered_map<std::string, std::string> reader_macros;
 };
 
@@ -11,6 +11,7 @@
  *   (+ 1 (+ a b)) ; compute the sum
  */
 
+#include <algorithm>
 #include "common/util/FileUtil.h"
 
 #include "TextDB.h"
@@ -51,29 +52,43 @@ std::string SourceText::get_line_containing_offset(int offset) {
 
 /*!
  * Get the index of the line containing the character at position "offset".
- * O(n_lines) crappy implementation.
+ * Returns -1 if not found.
+ */
+int SourceText::find_line_idx(int offset) const {
+  // the first line that ends at or after offset.
+  auto it = std::lower_bound(offset_by_line.begin() + 1, offset_by_line.end(), offset);
+  if (it == offset_by_line.end()) {
+    return -1;
+  }
+  int line = int(it - offset_by_line.begin()) - 1;
+  if (offset < offset_by_line[line]) {
+    return -1;
+  }
+  return line;
+}
+
+/*!
+ * Get the index of the line containing the character at position "offset".
  * Error if not found.
  */
 int SourceText::get_line_idx(int offset) {
-  for (uint32_t line = 0; line < offset_by_line.size() - 1; line++) {
-    if (offset >= offset_by_line[line] && offset <= offset_by_line[line + 1]) {
-      return line;
-    }
+  int line = find_line_idx(offset);
+  if (line < 0) {
+    throw std::runtime_error("Unable to get line index for character at position " +
+                             std::to_string(offset));
   }
-  throw std::runtime_error("Unable to get line index for character at position " +
-                           std::to_string(offset));
+  return line;
 }
 
 /*!
  * Gets the [start, end) character offset of the line containing the given offset.
  */
 std::pair<int, int> SourceText::get_containing_line(int offset) {
-  for (uint32_t line = 0; line < offset_by_line.size() - 1; line++) {
-    if (offset >= offset_by_line[line] && offset <= offset_by_line[line + 1]) {
-      return std::make_pair(offset_by_line[line], offset_by_line[line + 1]);
-    }
+  int line = find_line_idx(offset);
+  if (line < 0) {
+    return std::make_pair(0, text.size());
   }
-  return std::make_pair(0, text.size());
+  return std::make_pair(offset_by_line[line], offset_by_line[line + 1]);
 }
 
 /*!
@@ -84,25 +99,17 @@ FileText::FileText(std::string filename_) : filename(std::move(filename_)) {
   build_offsets();
 }
 
-/*!
- * Inform the TextDB about a source of text.
- */
-void TextDb::insert(const std::shared_ptr<SourceText>& frag) {
-  fragments.push_back(frag);
-}
-
 /*!
  * Link the GOOS object o to the offset into the given text fragment.
  * The object _must_ be a pair or empty list.
  */
-void TextDb::link(const Object& o, std::shared_ptr<SourceText> frag, int offset) {
+void TextDb::link(const Object& o, const std::shared_ptr<SourceText>& frag, int offset) {
   if (o.is_empty_list())
     return;
   assert(o.is_pair());
-  TextRef ref;
-  ref.offset = offset;
-  ref.frag = std::move(frag);
-  map[o.heap_obj] = ref;
+  auto pair = o.as_pair();
+  pair->source = frag;
+  pair->source_offset = offset;
 }
 
 /*!
@@ -110,12 +117,13 @@ void TextDb::link(const Object& o, std::shared_ptr<SourceText> frag, int offset)
  */
 std::string TextDb::get_info_for(const Object& o, bool* terminate_compiler_error) {
   if (o.is_pair()) {
-    auto kv = map.find(o.heap_obj);
-    if (kv != map.end()) {
+    auto pair = o.as_pair();
+    if (pair->source) {
+      auto& frag = pair->source;
       if (terminate_compiler_error) {
-        *terminate_compiler_error = kv->second.frag->terminate_compiler_error();
+        *terminate_compiler_error = frag->terminate_compiler_error();
       }
-      return get_info_for(kv->second.frag, kv->second.offset);
+      return get_info_for(frag, pair->source_offset);
     } else {
       if (terminate_compiler_error) {
         *terminate_compiler_error = false;
@@ -16,7 +16,6 @@
 #include <string>
 #include <vector>
 #include <stdexcept>
-#include <unordered_map>
 #include <memory>
 
 #include "common/goos/Object.h"
@@ -34,6 +33,7 @@ class SourceText {
   virtual std::string get_description() = 0;
   std::string get_line_containing_offset(int offset);
   int get_line_idx(int offset);
+  int find_line_idx(int offset) const;
   // should the compiler keep looking up the stack when printing errors on this, or not?
   // this should return true if the text source is specific enough so that they can find what they
   // want
@@ -82,20 +82,15 @@ class FileText : public SourceText {
   std::string filename;
 };
 
-struct TextRef {
-  int offset;
-  std::shared_ptr<SourceText> frag;
-};
-
+/*!
+ * Looks up where pairs came from.
+ * The location of a pair is stored in the pair itself as its text and an offset, so the database
+ * doesn't keep forms alive, and a text is freed when no forms read from it are left.
+ */
 class TextDb {
  public:
-  void insert(const std::shared_ptr<SourceText>& frag);
-  void link(const Object& o, std::shared_ptr<SourceText> frag, int offset);
+  void link(const Object& o, const std::shared_ptr<SourceText>& frag, int offset);
   std::string get_info_for(const Object& o, bool* terminate_compiler_error = nullptr);
   std::string get_info_for(const std::shared_ptr<SourceText>& frag, int offset);
-
- private:
-  std::vector<std::shared_ptr<SourceText>> fragments;
-  std::unordered_map<std::shared_ptr<goos::HeapObject>, TextRef> map;
 };
 }  // namespace goos
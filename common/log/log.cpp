@@ -34,33 +34,64 @@ const char* log_level_names[] = {"trace", "debug", "info", "warn", "error", "die
 const fmt::color log_colors[] = {fmt::color::gray,   fmt::color::turquoise, fmt::color::light_green,
                                  fmt::color::yellow, fmt::color::red,       fmt::color::hot_pink};
 
-void log_message(level log_level, LogTime& now, const char* message) {
+bool is_enabled(level log_level) {
+  return log_level >= gLogger.stdout_log_level ||
+         (gLogger.fp && log_level >= gLogger.file_log_level);
+}
+
+namespace {
+/*!
+ * Write the date of now into out, like [2021-01-01 12:34:56:789].
+ * The date and time part only changes once per second, so each thread remembers the last one.
+ */
+void format_date(const LogTime& now, char* out, size_t size) {
+  struct DateCache {
+    time_t seconds = -1;
+    char text[32] = {0};
+  };
+  thread_local DateCache cache;
+
 #ifdef __linux__
-  char date_time_buffer[128];
   time_t now_seconds = now.tv.tv_sec;
-  auto now_milliseconds = now.tv.tv_usec / 1000;
-  strftime(date_time_buffer, 128, "%Y-%m-%d %H:%M:%S", localtime(&now_seconds));
-  std::string date_string = fmt::format("[{}:{:03d}]", date_time_buffer, now_milliseconds);
 #else
-  char date_time_buffer[128];
-  strftime(date_time_buffer, 128, "%Y-%m-%d %H:%M:%S", localtime(&now.tim));
-  std::string date_string = fmt::format("[{}]", date_time_buffer);
+  time_t now_seconds = now.tim;
+#endif
+
+  if (now_seconds != cache.seconds) {
+    tm local_time;
+#ifdef _WIN32
+    localtime_s(&local_time, &now_seconds);
+#else
+    localtime_r(&now_seconds, &local_time);
 #endif
+    strftime(cache.text, sizeof(cache.text), "%Y-%m-%d %H:%M:%S", &local_time);
+    cache.seconds = now_seconds;
+  }
+
+#ifdef __linux__
+  snprintf(out, size, "[%s:%03d]", cache.text, int(now.tv.tv_usec / 1000));
+#else
+  snprintf(out, size, "[%s]", cache.text);
+#endif
+}
+}  // namespace
+
+void log_message(level log_level, LogTime& now, const char* message) {
+  char date[40];
+  format_date(now, date, sizeof(date));
 
   {
     std::lock_guard<std::mutex> lock(gLogger.mutex);
     if (gLogger.fp && log_level >= gLogger.file_log_level) {
       // log to file
-      std::string file_string =
-          fmt::format("{} [{}] {}\n", date_string, log_level_names[int(log_level)], message);
-      fwrite(file_string.c_str(), file_string.length(), 1, gLogger.fp);
+      fmt::print(gLogger.fp, "{} [{}] {}\n", date, log_level_names[int(log_level)], message);
       if (log_level >= gLogger.flush_level) {
         fflush(gLogger.fp);
       }
     }
 
     if (log_level >= gLogger.stdout_log_level) {
-      fmt::print("{} [", date_string);
+      fmt::print("{} [", date);
       fmt::print(fg(log_colors[int(log_level)]), "{}", log_level_names[int(log_level)]);
       fmt::print("] {}\n", message);
       if (log_level >= gLogger.flush_level) {
@@ -132,4 +163,4 @@ void finish() {
   }
 }
 
-}  // namespace lg
\ No newline at end of file
+}  // namespace lg
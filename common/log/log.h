@@ -8,6 +8,12 @@
 #include <string>
 #include "third-party/fmt/core.h"
 
+// Log messages below this level are removed at compile time.
+// For example, -DLG_COMPILE_MIN_LEVEL=2 removes all trace and debug messages.
+#ifndef LG_COMPILE_MIN_LEVEL
+#define LG_COMPILE_MIN_LEVEL 0
+#endif
+
 namespace lg {
 
 #ifdef __linux__
@@ -23,9 +29,12 @@ struct LogTime {
 // Logging API
 enum class level { trace = 0, debug = 1, info = 2, warn = 3, error = 4, die = 5 };
 
+constexpr level compiled_min_level = level(LG_COMPILE_MIN_LEVEL);
+
 namespace internal {
 // log implementation stuff, not to be called by the user
 void log_message(level log_level, LogTime& now, const char* message);
+bool is_enabled(level log_level);
 }  // namespace internal
 
 void set_file(const std::string& filename);
@@ -38,6 +47,10 @@ void finish();
 
 template <typename... Args>
 void log(level log_level, const std::string& format, Args&&... args) {
+  // skip the formatting if nobody will see this message.
+  if (log_level != level::die && !internal::is_enabled(log_level)) {
+    return;
+  }
   LogTime now;
 #ifdef __linux__
   gettimeofday(&now.tv, nullptr);
@@ -50,27 +63,37 @@ void log(level log_level, const std::string& format, Args&&... args) {
 
 template <typename... Args>
 void trace(const std::string& format, Args&&... args) {
-  log(level::trace, format, std::forward<Args>(args)...);
+  if constexpr (level::trace >= compiled_min_level) {
+    log(level::trace, format, std::forward<Args>(args)...);
+  }
 }
 
 template <typename... Args>
 void debug(const std::string& format, Args&&... args) {
-  log(level::debug, format, std::forward<Args>(args)...);
+  if constexpr (level::debug >= compiled_min_level) {
+    log(level::debug, format, std::forward<Args>(args)...);
+  }
 }
 
 template <typename... Args>
 void info(const std::string& format, Args&&... args) {
-  log(level::info, format, std::forward<Args>(args)...);
+  if constexpr (level::info >= compiled_min_level) {
+    log(level::info, format, std::forward<Args>(args)...);
+  }
 }
 
 template <typename... Args>
 void warn(const std::string& format, Args&&... args) {
-  log(level::warn, format, std::forward<Args>(args)...);
+  if constexpr (level::warn >= compiled_min_level) {
+    log(level::warn, format, std::forward<Args>(args)...);
+  }
 }
 
 template <typename... Args>
 void error(const std::string& format, Args&&... args) {
-  log(level::error, format, std::forward<Args>(args)...);
+  if constexpr (level::error >= compiled_min_level) {
+    log(level::error, format, std::forward<Args>(args)...);
+  }
 }
 
 template <typename... Args>
@@ -0,0 +1,48 @@
+#pragma once
+
+/*!
+ * @file profiler_common.h
+ * Layout of the sample buffer shared between the runtime's sampling profiler and the compiler.
+ * The runtime writes samples of the EE thread into a memfd, which the debugger maps to read them.
+ */
+
+#include <atomic>
+#include "common/common_types.h"
+
+// name of the memfd holding the ProfilerBuffer, so the debugger can find it.
+constexpr const char* PROFILER_SHARED_NAME = "opengoal-profile-samples";
+constexpr u32 PROFILER_MAGIC = 0x666f7270;  // "prof"
+
+// number of samples kept. Older samples are overwritten.
+constexpr u32 PROFILER_SAMPLE_COUNT = 16384;
+
+// number of 8-byte words copied from the top of the stack with each sample.
+// GOAL code doesn't keep frame pointers, so the call stack is recovered by looking for return
+// addresses in these.
+constexpr int PROFILER_STACK_WORDS = 32;
+
+// default sample rate, in samples per second.
+constexpr u32 PROFILER_DEFAULT_HZ = 1000;
+
+struct ProfilerSample {
+  u64 rip;          //! x86 address that was running
+  u64 stack_words;  //! number of valid entries in stack
+  u64 stack[PROFILER_STACK_WORDS];  //! copy of the stack, starting at rsp
+};
+
+/*!
+ * Ring buffer of samples. There is a single writer (the signal handler on the EE thread), which
+ * never waits. Sample number i is stored in samples[i % PROFILER_SAMPLE_COUNT], and write_count is
+ * updated after a sample is written. A reader should check write_count again after copying to see
+ * which samples were overwritten while it was reading.
+ */
+struct ProfilerBuffer {
+  u32 magic;
+  u32 hz;                        //! sample rate, or 0 if not running
+  u64 ee_base;                   //! x86 address of EE memory, to convert samples to GOAL addresses
+  std::atomic<u64> write_count;  //! number of samples ever written
+  ProfilerSample samples[PROFILER_SAMPLE_COUNT];
+};
+
+// the buffer is shared between processes, so the counter must not need a lock.
+static_assert(std::atomic<u64>::is_always_lock_free);
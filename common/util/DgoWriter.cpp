@@ -3,31 +3,174 @@
  * Create a DGO from existing files.
  */
 
-#include "BinaryWriter.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+#include "third-party/fmt/core.h"
 #include "FileUtil.h"
 #include "DgoWriter.h"
+#include "parallel_for.h"
 
-void build_dgo(const DgoDescription& description) {
-  BinaryWriter writer;
-  // dgo header
-  writer.add<uint32_t>(description.entries.size());
-  writer.add_cstr_len(description.dgo_name.c_str(), 60);
+namespace {
+constexpr size_t DGO_HEADER_SIZE = 64;
+constexpr size_t DGO_ENTRY_HEADER_SIZE = 64;
+constexpr size_t DGO_NAME_LENGTH = 60;
+
+/*!
+ * A DGO, ready to be written.
+ */
+struct DgoData {
+  std::vector<uint8_t> data;
+  uint64_t hash = 0;
+};
+
+size_t align16(size_t x) {
+  return (x + 15) & ~size_t(15);
+}
+
+/*!
+ * 64-bit FNV-1a hash.
+ */
+uint64_t hash_data(const uint8_t* data, size_t size) {
+  uint64_t hash = 14695981039346656037ull;
+  for (size_t i = 0; i < size; i++) {
+    hash ^= data[i];
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
+void write_name(uint8_t* dest, const std::string& name) {
+  // the rest is already zero.
+  memcpy(dest, name.c_str(), std::min(name.length(), DGO_NAME_LENGTH));
+}
 
+/*!
+ * Read a file into a buffer that has exactly the right size.
+ */
+void read_file_into(const std::string& filename, uint8_t* dest, size_t size) {
+  auto fp = fopen(filename.c_str(), "rb");
+  if (!fp) {
+    throw std::runtime_error("File " + filename +
+                             " cannot be opened: " + std::string(strerror(errno)));
+  }
+  if (size && fread(dest, size, 1, fp) != 1) {
+    fclose(fp);
+    throw std::runtime_error("File " + filename + " cannot be read");
+  }
+  fclose(fp);
+}
+
+/*!
+ * Build the DGO in memory. The object files are looked up first so the output can be allocated
+ * once, and each object file is read directly to its spot in the output.
+ */
+DgoData make_dgo(const DgoDescription& description) {
+  std::vector<std::string> paths;
+  std::vector<size_t> sizes;
+  paths.reserve(description.entries.size());
+  sizes.reserve(description.entries.size());
+  size_t total_size = DGO_HEADER_SIZE;
   for (auto& obj : description.entries) {
-    auto obj_data =
-        file_util::read_binary_file(file_util::get_file_path({"out", "obj", obj.file_name}));
+    paths.push_back(file_util::get_file_path({"out", "obj", obj.file_name}));
+    sizes.push_back(std::filesystem::file_size(paths.back()));
+    total_size += DGO_ENTRY_HEADER_SIZE + align16(sizes.back());
+  }
+
+  DgoData result;
+  result.data.resize(total_size);
+  auto out = result.data.data();
+
+  // dgo header
+  uint32_t count = description.entries.size();
+  memcpy(out, &count, sizeof(uint32_t));
+  write_name(out + 4, description.dgo_name);
+
+  size_t offset = DGO_HEADER_SIZE;
+  for (size_t i = 0; i < description.entries.size(); i++) {
     // size
-    writer.add<uint32_t>(obj_data.size());
+    uint32_t size = sizes[i];
+    memcpy(out + offset, &size, sizeof(uint32_t));
     // name
-    writer.add_str_len(obj.name_in_dgo, 60);
-    // data
-    writer.add_data(obj_data.data(), obj_data.size());
-    // pad
-    while (writer.get_size() & 0xf) {
-      writer.add<uint8_t>(0);
-    }
+    write_name(out + offset + 4, description.entries[i].name_in_dgo);
+    offset += DGO_ENTRY_HEADER_SIZE;
+    // data, then padding to 16 bytes, which is already zero
+    read_file_into(paths[i], out + offset, sizes[i]);
+    offset += align16(sizes[i]);
+  }
+
+  result.hash = hash_data(result.data.data(), result.data.size());
+  return result;
+}
+
+void write_dgo(const DgoDescription& description, const DgoData& dgo) {
+  file_util::write_binary_file(file_util::get_file_path({"out", "iso", description.dgo_name}),
+                               dgo.data.data(), dgo.data.size());
+}
+
+/*!
+ * The manifest remembers the hash of each DGO we wrote, so we don't write it again if nothing
+ * changed. Each line is a DGO name and its hash.
+ */
+std::string manifest_path() {
+  return file_util::get_file_path({"out", "iso", "dgo-manifest.txt"});
+}
+
+std::unordered_map<std::string, uint64_t> read_manifest() {
+  std::unordered_map<std::string, uint64_t> result;
+  if (!std::filesystem::exists(manifest_path())) {
+    return result;
   }
+  std::istringstream text(file_util::read_text_file(manifest_path()));
+  std::string name, hash;
+  while (text >> name >> hash) {
+    result[name] = std::stoull(hash, nullptr, 16);
+  }
+  return result;
+}
+
+void write_manifest(const std::unordered_map<std::string, uint64_t>& hashes) {
+  // sorted, so the file doesn't change if the hashes don't.
+  std::vector<std::pair<std::string, uint64_t>> sorted(hashes.begin(), hashes.end());
+  std::sort(sorted.begin(), sorted.end());
+  std::string text;
+  for (auto& entry : sorted) {
+    text += fmt::format("{} {:016x}\n", entry.first, entry.second);
+  }
+  file_util::write_text_file(manifest_path(), text);
+}
+}  // namespace
 
+/*!
+ * Build many DGOs at once. DGOs are built in parallel, and DGOs which are the same as the last time
+ * they were built aren't written again.
+ */
+void build_dgos(const std::vector<DgoDescription>& descriptions) {
   file_util::create_dir_if_needed(file_util::get_file_path({"out", "iso"}));
-  writer.write_to_file(file_util::get_file_path({"out", "iso", description.dgo_name}));
+  auto old_hashes = read_manifest();
+  std::vector<uint64_t> hashes(descriptions.size());
+
+  parallel_for(descriptions.size(), [&](size_t i) {
+    auto& description = descriptions[i];
+    auto dgo = make_dgo(description);
+    hashes[i] = dgo.hash;
+
+    auto old = old_hashes.find(description.dgo_name);
+    auto path = file_util::get_file_path({"out", "iso", description.dgo_name});
+    if (old != old_hashes.end() && old->second == dgo.hash && std::filesystem::exists(path) &&
+        std::filesystem::file_size(path) == dgo.data.size()) {
+      return;
+    }
+    write_dgo(description, dgo);
+  });
+
+  // keep the hashes of DGOs that weren't built this time.
+  for (size_t i = 0; i < descriptions.size(); i++) {
+    old_hashes[descriptions[i].dgo_name] = hashes[i];
+  }
+  write_manifest(old_hashes);
 }
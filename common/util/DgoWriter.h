@@ -5,6 +5,7 @@
  * Create a DGO from existing files.
  */
 
+#include <string>
 #include <vector>
 
 struct DgoDescription {
@@ -16,4 +17,4 @@ struct DgoDescription {
   std::vector<DgoEntry> entries;
 };
 
-void build_dgo(const DgoDescription& description);
+void build_dgos(const std::vector<DgoDescription>& descriptions);
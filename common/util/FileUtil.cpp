@@ -100,7 +100,8 @@ void write_text_file(const std::string& file_name, const std::string& text) {
     printf("Failed to fopen %s\n", file_name.c_str());
     throw std::runtime_error("Failed to open file");
   }
-  fprintf(fp, "%s\n", text.c_str());
+  fwrite(text.data(), 1, text.size(), fp);
+  fputc('\n', fp);
   fclose(fp);
 }
 
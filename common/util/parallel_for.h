@@ -0,0 +1,81 @@
+#pragma once
+
+/*!
+ * @file parallel_for.h
+ * Run independent tasks on a group of worker threads.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*!
+ * Get the number of worker threads to use by default. Always at least 1.
+ */
+inline int parallel_thread_count() {
+  int result = (int)std::thread::hardware_concurrency();
+  return std::max(result, 1);
+}
+
+/*!
+ * Call f(i) for each i in [0, count). The calls may happen in any order and on any thread, but all
+ * calls will have finished when this returns.
+ * Tasks are handed out one at a time, so uneven task sizes are fine.
+ * If a task throws, the remaining tasks are skipped and the first exception is rethrown here.
+ * If max_threads <= 0, parallel_thread_count() threads are used.
+ */
+template <typename Func>
+void parallel_for(size_t count, Func&& f, int max_threads = -1) {
+  if (max_threads <= 0) {
+    max_threads = parallel_thread_count();
+  }
+
+  size_t thread_count = std::min(count, (size_t)max_threads);
+  if (thread_count <= 1) {
+    for (size_t i = 0; i < count; i++) {
+      f(i);
+    }
+    return;
+  }
+
+  std::atomic<size_t> next_task = {0};
+  std::atomic<bool> failed = {false};
+  std::exception_ptr first_exception;
+  std::mutex exception_mutex;
+
+  auto worker = [&]() {
+    while (!failed.load()) {
+      size_t i = next_task.fetch_add(1);
+      if (i >= count) {
+        return;
+      }
+      try {
+        f(i);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(exception_mutex);
+        if (!first_exception) {
+          first_exception = std::current_exception();
+        }
+        failed = true;
+      }
+    }
+  };
+
+  // the calling thread does work too.
+  std::vector<std::thread> threads;
+  threads.reserve(thread_count - 1);
+  for (size_t i = 0; i < thread_count - 1; i++) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  if (first_exception) {
+    std::rethrow_exception(first_exception);
+  }
+}
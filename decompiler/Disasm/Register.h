@@ -145,6 +145,7 @@ class Register {
   bool operator==(const Register& other) const;
   bool operator!=(const Register& other) const;
   bool operator<(const Register& other) const { return id < other.id; }
+  uint16_t reg_id() const { return id; }
 
   struct hash {
     auto operator()(const Register& x) const { return std::hash<uint16_t>()(x.id); }
@@ -2,6 +2,7 @@
 
 #include <vector>
 #include <memory>
+#include <unordered_set>
 
 // for RegSet:
 #include "decompiler/analysis/reg_usage.h"
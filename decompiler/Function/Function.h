@@ -91,7 +91,7 @@ class Function {
   int get_failed_basic_op_count();
 
   bool run_type_analysis_ir2(const TypeSpec& my_type,
-                             DecompilerTypeSystem& dts,
+                             const DecompilerTypeSystem& dts,
                              LinkedObjectFile& file,
                              const std::unordered_map<int, std::vector<TypeHint>>& hints);
   BlockTopologicalSort bb_topo_sort();
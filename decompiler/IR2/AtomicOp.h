@@ -72,7 +72,9 @@ class AtomicOp {
 
   virtual void collect_vars(VariableSet& vars) const = 0;
 
-  TypeState propagate_types(const TypeState& input, const Env& env, DecompilerTypeSystem& dts);
+  TypeState propagate_types(const TypeState& input,
+                            const Env& env,
+                            const DecompilerTypeSystem& dts);
 
   int op_id() const { return m_my_idx; }
   const std::vector<Register>& read_regs() const { return m_read_regs; }
@@ -93,7 +95,7 @@ class AtomicOp {
   // given the input types of all registers, figure out the output types.
   virtual TypeState propagate_types_internal(const TypeState& input,
                                              const Env& env,
-                                             DecompilerTypeSystem& dts) = 0;
+                                             const DecompilerTypeSystem& dts) = 0;
   void clobber_temps();
 
   // the register values that are read (at the start of this op)
@@ -268,7 +270,7 @@ class SetVarOp : public AtomicOp {
   void update_register_info() override;
   TypeState propagate_types_internal(const TypeState& input,
                                      const Env& env,
-                                     DecompilerTypeSystem& dts) override;
+                                     const DecompilerTypeSystem& dts) override;
   void collect_vars(VariableSet& vars) const override;
   const Variable& dst() const { return m_dst; }
   const SimpleExpression& src() const { return m_src; }
@@ -296,7 +298,7 @@ class AsmOp : public AtomicOp {
   void update_register_info() override;
   TypeState propagate_types_internal(const TypeState& input,
                                      const Env& env,
-                                     DecompilerTypeSystem& dts) override;
+                                     const DecompilerTypeSystem& dts) override;
   void collect_vars(VariableSet& vars) const override;
   const Instruction& instruction() const { return m_instr; }
 
@@ -393,7 +395,7 @@ class SetVarConditionOp : public AtomicOp {
   void invert() { m_condition.invert(); }
   TypeState propagate_types_internal(const TypeState& input,
                                      const Env& env,
-                                     DecompilerTypeSystem& dts) override;
+                                     const DecompilerTypeSystem& dts) override;
   void collect_vars(VariableSet& vars) const override;
 
  private:
@@ -417,7 +419,7 @@ class StoreOp : public AtomicOp {
   void update_register_info() override;
   TypeState propagate_types_internal(const TypeState& input,
                                      const Env& env,
-                                     DecompilerTypeSystem& dts) override;
+                                     const DecompilerTypeSystem& dts) override;
   void collect_vars(VariableSet& vars) const override;
   const SimpleExpression& addr() const { return m_addr; }
   const SimpleAtom& value() const { return m_value; }
@@ -445,8 +447,10 @@ class LoadVarOp : public AtomicOp {
   void update_register_info() override;
   TypeState propagate_types_internal(const TypeState& input,
                                      const Env& env,
-                                     DecompilerTypeSystem& dts) override;
-  TP_Type get_src_type(const TypeState& input, const Env& env, DecompilerTypeSystem& dts) const;
+                                     const DecompilerTypeSystem& dts) override;
+  TP_Type get_src_type(const TypeState& input,
+                       const Env& env,
+                       const DecompilerTypeSystem& dts) const;
   void collect_vars(VariableSet& vars) const override;
 
  private:
@@ -488,7 +492,7 @@ class IR2_BranchDelay {
   bool is_known() const { return m_kind != Kind::UNKNOWN; }
   TypeState propagate_types(const TypeState& input,
                             const Env& env,
-                            DecompilerTypeSystem& dts) const;
+                            const DecompilerTypeSystem& dts) const;
   void collect_vars(VariableSet& vars) const;
   Kind kind() const { return m_kind; }
   const Variable& var(int idx) const {
@@ -521,7 +525,7 @@ class BranchOp : public AtomicOp {
   void update_register_info() override;
   TypeState propagate_types_internal(const TypeState& input,
                                      const Env& env,
-                                     DecompilerTypeSystem& dts) override;
+                                     const DecompilerTypeSystem& dts) override;
   void collect_vars(VariableSet& vars) const override;
   const IR2_BranchDelay& branch_delay() const { return m_branch_delay; }
   const IR2_Condition& condition() const { return m_condition; }
@@ -557,7 +561,7 @@ class SpecialOp : public AtomicOp {
   void update_register_info() override;
   TypeState propagate_types_internal(const TypeState& input,
                                      const Env& env,
-                                     DecompilerTypeSystem& dts) override;
+                                     const DecompilerTypeSystem& dts) override;
   void collect_vars(VariableSet& vars) const override;
   Kind kind() const { return m_kind; }
 
@@ -580,7 +584,7 @@ class CallOp : public AtomicOp {
   void update_register_info() override;
   TypeState propagate_types_internal(const TypeState& input,
                                      const Env& env,
-                                     DecompilerTypeSystem& dts) override;
+                                     const DecompilerTypeSystem& dts) override;
   void collect_vars(VariableSet& vars) const override;
   const std::vector<Variable>& arg_vars() const { return m_arg_vars; }
   Variable function_var() const { return m_function_var; }
@@ -617,7 +621,7 @@ class ConditionalMoveFalseOp : public AtomicOp {
   void update_register_info() override;
   TypeState propagate_types_internal(const TypeState& input,
                                      const Env& env,
-                                     DecompilerTypeSystem& dts) override;
+                                     const DecompilerTypeSystem& dts) override;
   void collect_vars(VariableSet& vars) const override;
 
  private:
@@ -649,7 +653,7 @@ class FunctionEndOp : public AtomicOp {
   void update_register_info() override;
   TypeState propagate_types_internal(const TypeState& input,
                                      const Env& env,
-                                     DecompilerTypeSystem& dts) override;
+                                     const DecompilerTypeSystem& dts) override;
   void collect_vars(VariableSet& vars) const override;
   void mark_function_as_no_return_value();
   const Variable& return_var() const {
@@ -90,14 +90,13 @@ FormElement* SetVarOp::get_as_form(FormPool& pool, const Env& env) const {
     } else if (m_src.get_arg(0).is_var()) {
       auto& src_var = m_src.get_arg(0).var();
       auto& ri = env.reg_use().op.at(m_my_idx);
-      if (ri.consumes.find(src_var.reg()) != ri.consumes.end() &&
-          ri.written_and_unused.find(dst().reg()) != ri.written_and_unused.end()) {
+      if (ri.consumes.contains(src_var.reg()) && ri.written_and_unused.contains(dst().reg())) {
         result->mark_as_dead_set();
         // fmt::print("marked {} as dead set\n", to_string(env));
       }
     } else if (m_src.get_arg(0).is_sym_ptr() && m_src.get_arg(0).get_str() == "#f") {
       auto& ri = env.reg_use().op.at(m_my_idx);
-      if (ri.written_and_unused.find(dst().reg()) != ri.written_and_unused.end()) {
+      if (ri.written_and_unused.contains(dst().reg())) {
         result->mark_as_dead_false();
         // fmt::print("marked {} as dead set false\n", to_string(env));
       }
@@ -412,7 +411,7 @@ FormElement* CallOp::get_as_form(FormPool& pool, const Env& env) const {
   } else if (m_write_regs.size() == 1 || !m_call_type_set) {
     if (env.has_reg_use() && m_write_regs.size() == 1) {
       auto& written_and_unused = env.reg_use().op.at(m_my_idx).written_and_unused;
-      if (written_and_unused.find(m_write_regs.front()) != written_and_unused.end()) {
+      if (written_and_unused.contains(m_write_regs.front())) {
         return call;
       }
     }
@@ -351,7 +351,7 @@ TP_Type SimpleExpression::get_type_int2(const TypeState& input,
 
 TypeState IR2_BranchDelay::propagate_types(const TypeState& input,
                                            const Env& env,
-                                           DecompilerTypeSystem& dts) const {
+                                           const DecompilerTypeSystem& dts) const {
   TypeState output = input;
   switch (m_kind) {
     case Kind::DSLLV: {
@@ -404,7 +404,7 @@ TypeState IR2_BranchDelay::propagate_types(const TypeState& input,
 
 TypeState AtomicOp::propagate_types(const TypeState& input,
                                     const Env& env,
-                                    DecompilerTypeSystem& dts) {
+                                    const DecompilerTypeSystem& dts) {
   // do op-specific type propagation
   TypeState result = propagate_types_internal(input, env, dts);
   // clobber
@@ -416,7 +416,7 @@ TypeState AtomicOp::propagate_types(const TypeState& input,
 
 TypeState SetVarOp::propagate_types_internal(const TypeState& input,
                                              const Env& env,
-                                             DecompilerTypeSystem& dts) {
+                                             const DecompilerTypeSystem& dts) {
   TypeState result = input;
   result.get(m_dst.reg()) = m_src.get_type(input, env, dts);
   return result;
@@ -424,7 +424,7 @@ TypeState SetVarOp::propagate_types_internal(const TypeState& input,
 
 TypeState AsmOp::propagate_types_internal(const TypeState& input,
                                           const Env& env,
-                                          DecompilerTypeSystem& dts) {
+                                          const DecompilerTypeSystem& dts) {
   (void)env;
   (void)dts;
   TypeState result = input;
@@ -439,7 +439,7 @@ TypeState AsmOp::propagate_types_internal(const TypeState& input,
 
 TypeState SetVarConditionOp::propagate_types_internal(const TypeState& input,
                                                       const Env& env,
-                                                      DecompilerTypeSystem& dts) {
+                                                      const DecompilerTypeSystem& dts) {
   (void)env;
   (void)dts;
   TypeState result = input;
@@ -449,7 +449,7 @@ TypeState SetVarConditionOp::propagate_types_internal(const TypeState& input,
 
 TypeState StoreOp::propagate_types_internal(const TypeState& input,
                                             const Env& env,
-                                            DecompilerTypeSystem& dts) {
+                                            const DecompilerTypeSystem& dts) {
   (void)env;
   (void)dts;
   return input;
@@ -457,7 +457,7 @@ TypeState StoreOp::propagate_types_internal(const TypeState& input,
 
 TP_Type LoadVarOp::get_src_type(const TypeState& input,
                                 const Env& env,
-                                DecompilerTypeSystem& dts) const {
+                                const DecompilerTypeSystem& dts) const {
   if (m_src.is_identity()) {
     auto& src = m_src.get_arg(0);
     if (src.is_static_addr()) {
@@ -597,7 +597,7 @@ TP_Type LoadVarOp::get_src_type(const TypeState& input,
     auto rd = dts.ts.reverse_field_lookup(rd_in);
 
     // only error on failure if "pair" is disabled. otherwise it might be a pair.
-    if (!rd.success && !dts.type_prop_settings.allow_pair) {
+    if (!rd.success && !env.allow_sloppy_pair_typing()) {
       printf("input type is %s, offset is %d, sign %d size %d\n", rd_in.base_type.print().c_str(),
              rd_in.offset, rd_in.deref.value().sign_extend, rd_in.deref.value().size);
       throw std::runtime_error(fmt::format("Could not get type of load: {}. Reverse Deref Failed.",
@@ -615,7 +615,7 @@ TP_Type LoadVarOp::get_src_type(const TypeState& input,
     }
 
     // rd failed, try as pair.
-    if (dts.type_prop_settings.allow_pair) {
+    if (env.allow_sloppy_pair_typing()) {
       // we are strict here - only permit pair-type loads from object or pair.
       // object is permitted for stuff like association lists where the car is also a pair.
       if (m_kind == Kind::SIGNED && m_size == 4 &&
@@ -643,7 +643,7 @@ TP_Type LoadVarOp::get_src_type(const TypeState& input,
 
 TypeState LoadVarOp::propagate_types_internal(const TypeState& input,
                                               const Env& env,
-                                              DecompilerTypeSystem& dts) {
+                                              const DecompilerTypeSystem& dts) {
   TypeState result = input;
   result.get(m_dst.reg()) = get_src_type(input, env, dts);
   return result;
@@ -651,13 +651,13 @@ TypeState LoadVarOp::propagate_types_internal(const TypeState& input,
 
 TypeState BranchOp::propagate_types_internal(const TypeState& input,
                                              const Env& env,
-                                             DecompilerTypeSystem& dts) {
+                                             const DecompilerTypeSystem& dts) {
   return m_branch_delay.propagate_types(input, env, dts);
 }
 
 TypeState SpecialOp::propagate_types_internal(const TypeState& input,
                                               const Env& env,
-                                              DecompilerTypeSystem& dts) {
+                                              const DecompilerTypeSystem& dts) {
   (void)env;
   (void)dts;
   // none of these write anything. Suspend clobbers, but this is taken care of automatically
@@ -674,7 +674,7 @@ TypeState SpecialOp::propagate_types_internal(const TypeState& input,
 
 TypeState CallOp::propagate_types_internal(const TypeState& input,
                                            const Env& env,
-                                           DecompilerTypeSystem& dts) {
+                                           const DecompilerTypeSystem& dts) {
   (void)dts;
   (void)env;
   const Reg::Gpr arg_regs[8] = {Reg::A0, Reg::A1, Reg::A2, Reg::A3,
@@ -683,15 +683,12 @@ TypeState CallOp::propagate_types_internal(const TypeState& input,
   TypeState end_types = input;
 
   auto in_tp = input.get(Register(Reg::GPR, Reg::T9));
-  if (in_tp.kind == TP_Type::Kind::OBJECT_NEW_METHOD &&
-      !dts.type_prop_settings.current_method_type.empty()) {
+  if (in_tp.kind == TP_Type::Kind::OBJECT_NEW_METHOD && !env.method_type().empty()) {
     // calling object new method. Set the result to a new object of our type
-    end_types.get(Register(Reg::GPR, Reg::V0)) =
-        TP_Type::make_from_ts(dts.type_prop_settings.current_method_type);
+    end_types.get(Register(Reg::GPR, Reg::V0)) = TP_Type::make_from_ts(env.method_type());
     // update the call type
     m_call_type = in_tp.get_method_new_object_typespec();
-    m_call_type.get_arg(m_call_type.arg_count() - 1) =
-        TypeSpec(dts.type_prop_settings.current_method_type);
+    m_call_type.get_arg(m_call_type.arg_count() - 1) = TypeSpec(env.method_type());
     m_call_type_set = true;
 
     m_read_regs.clear();
@@ -782,7 +779,7 @@ TypeState CallOp::propagate_types_internal(const TypeState& input,
 
 TypeState ConditionalMoveFalseOp::propagate_types_internal(const TypeState& input,
                                                            const Env& env,
-                                                           DecompilerTypeSystem& dts) {
+                                                           const DecompilerTypeSystem& dts) {
   (void)env;
   (void)dts;
   // these should only appear when paired with a (set! dest #t) earlier, so this expression
@@ -799,7 +796,7 @@ TypeState ConditionalMoveFalseOp::propagate_types_internal(const TypeState& inpu
 
 TypeState FunctionEndOp::propagate_types_internal(const TypeState& input,
                                                   const Env&,
-                                                  DecompilerTypeSystem&) {
+                                                  const DecompilerTypeSystem&) {
   return input;
 }
 
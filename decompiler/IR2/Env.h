@@ -67,8 +67,8 @@ class Env {
     return m_block_init_types.at(block_id);
   }
 
-  void set_types(const std::vector<TypeState>& block_init_types,
-                 const std::vector<TypeState>& op_end_types,
+  void set_types(std::vector<TypeState> block_init_types,
+                 std::vector<TypeState> op_end_types,
                  const FunctionAtomicOps& atomic_ops);
 
   void set_local_vars(const VariableNames& names) {
@@ -90,6 +90,13 @@ class Env {
 
   bool allow_sloppy_pair_typing() const { return m_allow_sloppy_pair_typing; }
   void set_sloppy_pair_typing() { m_allow_sloppy_pair_typing = true; }
+
+  /*!
+   * The type of the method being analyzed, used to give a type to the result of calling the
+   * object new method. Empty if this function isn't a method.
+   */
+  const std::string& method_type() const { return m_method_type; }
+  void set_method_type(const std::string& type_name) { m_method_type = type_name; }
   void set_type_hints(const std::unordered_map<int, std::vector<TypeHint>>& hints) {
     m_typehints = hints;
   }
@@ -126,6 +133,7 @@ class Env {
   std::vector<TypeState*> m_op_init_types;
 
   bool m_allow_sloppy_pair_typing = false;
+  std::string m_method_type;
 
   std::unordered_map<int, std::vector<TypeHint>> m_typehints;
   std::unordered_map<std::string, std::string> m_var_remap;
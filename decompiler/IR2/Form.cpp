@@ -11,12 +11,13 @@ namespace decompiler {
 ///////////////////
 
 FormPool::~FormPool() {
+  // the memory is owned by the arena, so only run the destructors here.
   for (auto& x : m_forms) {
-    delete x;
+    x->~Form();
   }
 
   for (auto& x : m_elements) {
-    delete x;
+    x->~FormElement();
   }
 }
 
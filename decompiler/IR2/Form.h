@@ -3,6 +3,7 @@
 #include <vector>
 #include <unordered_set>
 #include <memory>
+#include <memory_resource>
 #include <functional>
 #include "decompiler/Disasm/Register.h"
 #include "decompiler/IR2/AtomicOp.h"
@@ -960,19 +961,27 @@ class StringConstantElement : public FormElement {
  */
 class Form {
  public:
+  using ElementList = std::pmr::vector<FormElement*>;
+
   Form() = default;
-  Form(FormElement* parent, FormElement* single_child)
-      : parent_element(parent), m_elements({single_child}) {
+  Form(FormElement* parent,
+       FormElement* single_child,
+       std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+      : parent_element(parent), m_elements({single_child}, resource) {
     single_child->parent_form = this;
   }
 
-  Form(FormElement* parent, const std::vector<FormElement*>& sequence)
-      : parent_element(parent), m_elements(sequence) {
+  Form(FormElement* parent,
+       const std::vector<FormElement*>& sequence,
+       std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+      : parent_element(parent), m_elements(sequence.begin(), sequence.end(), resource) {
     for (auto& x : sequence) {
       x->parent_form = this;
     }
   }
 
+  explicit Form(std::pmr::memory_resource* resource) : m_elements(resource) {}
+
   FormElement* try_as_single_element() const {
     if (is_single_element()) {
       return m_elements.front();
@@ -999,8 +1008,8 @@ class Form {
     m_elements.pop_back();
   }
 
-  const std::vector<FormElement*>& elts() const { return m_elements; }
-  std::vector<FormElement*>& elts() { return m_elements; }
+  const ElementList& elts() const { return m_elements; }
+  ElementList& elts() { return m_elements; }
 
   void push_back(FormElement* elt) {
     elt->parent_form = this;
@@ -1027,7 +1036,7 @@ class Form {
   FormElement* parent_element = nullptr;
 
  private:
-  std::vector<FormElement*> m_elements;
+  ElementList m_elements;
 };
 
 /*!
@@ -1035,44 +1044,43 @@ class Form {
  * It will clean up everything when it is destroyed.
  * As a result, you don't need to worry about deleting / referencing counting when manipulating
  * a Form graph.
+ * Forms, elements, and the lists of elements in forms are all allocated from a single arena that
+ * is only freed when the pool is destroyed.
  */
 class FormPool {
  public:
+  FormPool() = default;
+  FormPool(const FormPool&) = delete;
+  FormPool& operator=(const FormPool&) = delete;
+
   template <typename T, class... Args>
   T* alloc_element(Args&&... args) {
-    auto elt = new T(std::forward<Args>(args)...);
-    m_elements.emplace_back(elt);
+    auto elt = new (m_arena.allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    m_elements.push_back(elt);
     return elt;
   }
 
   template <typename T, class... Args>
   Form* alloc_single_element_form(FormElement* parent, Args&&... args) {
-    auto elt = new T(std::forward<Args>(args)...);
-    m_elements.emplace_back(elt);
+    auto elt = alloc_element<T>(std::forward<Args>(args)...);
     auto form = alloc_single_form(parent, elt);
     return form;
   }
 
   Form* alloc_single_form(FormElement* parent, FormElement* elt) {
-    auto form = new Form(parent, elt);
+    auto form = new (alloc_form_memory()) Form(parent, elt, &m_arena);
     m_forms.push_back(form);
     return form;
   }
 
-  Form* alloc_sequence_form(FormElement* parent, const std::vector<FormElement*> sequence) {
-    auto form = new Form(parent, sequence);
-    m_forms.push_back(form);
-    return form;
-  }
-
-  Form* acquire(std::unique_ptr<Form> form_ptr) {
-    Form* form = form_ptr.release();
+  Form* alloc_sequence_form(FormElement* parent, const std::vector<FormElement*>& sequence) {
+    auto form = new (alloc_form_memory()) Form(parent, sequence, &m_arena);
     m_forms.push_back(form);
     return form;
   }
 
   Form* alloc_empty_form() {
-    Form* form = new Form;
+    auto form = new (alloc_form_memory()) Form(&m_arena);
     m_forms.push_back(form);
     return form;
   }
@@ -1080,6 +1088,10 @@ class FormPool {
   ~FormPool();
 
  private:
+  void* alloc_form_memory() { return m_arena.allocate(sizeof(Form), alignof(Form)); }
+
+  // must be declared first, so it is destroyed after everything allocated in it.
+  std::pmr::monotonic_buffer_resource m_arena;
   std::vector<Form*> m_forms;
   std::vector<FormElement*> m_elements;
 };
@@ -105,7 +105,7 @@ void pop_helper(const std::vector<Variable>& vars,
     const auto& var = vars.at(var_idx);
     auto& ri = env.reg_use().op.at(var.idx());
     RegSet consumes_to_use = consumes.value_or(ri.consumes);
-    if (consumes_to_use.find(var.reg()) != consumes_to_use.end()) {
+    if (consumes_to_use.contains(var.reg())) {
       // we consume the register, so it's safe to try popping.
       submit_reg_to_var.push_back(var_idx);
       submit_regs.push_back(var.reg());
@@ -243,7 +243,7 @@ void Form::update_children_from_stack(const Env& env,
     x->parent_form = this;
   }
 
-  m_elements = new_elts;
+  m_elements.assign(new_elts.begin(), new_elts.end());
 }
 
 /*!
@@ -744,7 +744,7 @@ void SetVarElement::push_to_stack(const Env& env, FormPool& pool, FormStack& sta
           src_as_se->expr().get_arg(0).is_var()) {
         auto var = src_as_se->expr().get_arg(0).var();
         auto& info = env.reg_use().op.at(var.idx());
-        if (info.consumes.find(var.reg()) != info.consumes.end()) {
+        if (info.consumes.contains(var.reg())) {
           stack.push_non_seq_reg_to_reg(m_dst, src_as_se->expr().get_arg(0).var(), m_src,
                                         m_var_info);
           return;
@@ -1127,7 +1127,7 @@ void CondWithElseElement::push_to_stack(const Env& env, FormPool& pool, FormStac
   bool set_unused = false;
   if (rewrite_as_set) {
     auto& info = env.reg_use().op.at(last_var->idx());
-    if (info.written_and_unused.find(last_var->reg()) != info.written_and_unused.end()) {
+    if (info.written_and_unused.contains(last_var->reg())) {
       set_unused = true;
     }
   }
@@ -79,15 +79,6 @@ Form* FormStack::pop_reg(const Variable& var,
   return pop_reg(var.reg(), barrier, env, allow_side_effects);
 }
 
-namespace {
-bool nonempty_intersection(const RegSet& a, const RegSet& b) {
-  // todo - if we ever switch to bit reg sets, this could be a lot faster.
-  std::vector<Register> isect;
-  std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(isect));
-  return !isect.empty();
-}
-}  // namespace
-
 Form* FormStack::pop_reg(Register reg,
                          const RegSet& barrier,
                          const Env& env,
@@ -103,7 +94,7 @@ Form* FormStack::pop_reg(Register reg,
           // the source of the set! has a side effect and that's not allowed, so abort.
           return nullptr;
         }
-        if (nonempty_intersection(modified, barrier)) {
+        if (modified.intersects(barrier)) {
           // violating the barrier registers.
           return nullptr;
         }
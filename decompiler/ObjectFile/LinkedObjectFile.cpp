@@ -227,11 +227,9 @@ uint32_t LinkedObjectFile::set_ordered_label_names() {
 static const char* segment_names[] = {"main segment", "debug segment", "top-level segment"};
 
 /*!
- * Print all the words, with link information and labels.
+ * Print all the words, with link information and labels, to the end of a string.
  */
-std::string LinkedObjectFile::print_words() {
-  std::string result;
-
+void LinkedObjectFile::append_words_to_string(std::string& result) {
   assert(segments <= 3);
   for (int seg = segments; seg-- > 0;) {
     // segment header
@@ -256,8 +254,6 @@ std::string LinkedObjectFile::print_words() {
       append_word_to_string(result, word);
     }
   }
-
-  return result;
 }
 
 /*!
@@ -741,11 +737,10 @@ std::string LinkedObjectFile::print_asm_function_disassembly(const std::string&
 }
 
 /*!
- * Print disassembled functions and data segments.
+ * Print disassembled functions and data segments to the end of a string.
  */
-std::string LinkedObjectFile::print_disassembly() {
+void LinkedObjectFile::append_disassembly_to_string(std::string& result) {
   bool write_hex = get_config().write_hex_near_instructions;
-  std::string result;
 
   assert(segments <= 3);
   for (int seg = segments; seg-- > 0;) {
@@ -780,8 +775,6 @@ std::string LinkedObjectFile::print_disassembly() {
       }
     }
   }
-
-  return result;
 }
 
 /*!
@@ -46,12 +46,12 @@ class LinkedObjectFile {
   std::string get_label_name(int label_id) const;
   uint32_t set_ordered_label_names();
   void find_code();
-  std::string print_words();
+  void append_words_to_string(std::string& dest);
   void find_functions();
   void disassemble_functions();
   void process_fp_relative_links();
   std::string print_scripts();
-  std::string print_disassembly();
+  void append_disassembly_to_string(std::string& dest);
   bool has_any_functions();
   void append_word_to_string(std::string& dest, const LinkedWord& word) const;
   std::string to_asm_json(const std::string& obj_file_name);
@@ -7,6 +7,8 @@
 
 #include "ObjectFileDB.h"
 #include <algorithm>
+#include <atomic>
+#include <mutex>
 #include <set>
 #include <cstring>
 #include <map>
@@ -22,6 +24,7 @@
 #include "common/util/BinaryReader.h"
 #include "common/util/Timer.h"
 #include "common/util/FileUtil.h"
+#include "common/util/parallel_for.h"
 #include "decompiler/Function/BasicBlocks.h"
 #include "decompiler/IR/BasicOpBuilder.h"
 #include "decompiler/Function/TypeInspector.h"
@@ -115,7 +118,9 @@ ObjectFileDB::ObjectFileDB(const std::vector<std::string>& _dgos,
   Timer timer;
 
   lg::info("-Loading types...");
+  Timer type_timer;
   dts.parse_type_defs({"decompiler", "config", "all-types.gc"});
+  lg::info("-Loaded types in {:.2f} ms", type_timer.getMs());
 
   if (!obj_file_name_map_file.empty()) {
     lg::info("-Loading obj name map file...");
@@ -128,9 +133,7 @@ ObjectFileDB::ObjectFileDB(const std::vector<std::string>& _dgos,
   }
 
   lg::info("-Loading {} DGOs...", _dgos.size());
-  for (auto& dgo : _dgos) {
-    get_objs_from_dgo(dgo);
-  }
+  get_objs_from_dgos(_dgos);
 
   lg::info("-Loading {} plain object files...", object_files.size());
   for (auto& obj : object_files) {
@@ -187,69 +190,122 @@ void ObjectFileDB::load_map_file(const std::string& map_data) {
   }
 }
 
+namespace {
 constexpr int MAX_CHUNK_SIZE = 0x8000;
+
 /*!
- * Load the objects stored in the given DGO into the ObjectFileDB
+ * A single chunk of a Jak 2 compressed DGO.
  */
-void ObjectFileDB::get_objs_from_dgo(const std::string& filename) {
-  auto dgo_data = file_util::read_binary_file(filename);
-  stats.total_dgo_bytes += dgo_data.size();
+struct DgoChunk {
+  size_t src_offset = 0;    // offset of the chunk data in the compressed file
+  size_t src_size = 0;      // size of the chunk data in the compressed file
+  size_t dst_offset = 0;    // offset in the decompressed DGO
+  size_t dst_size = 0;      // size in the decompressed DGO
+  bool compressed = false;  // if false, the data is stored without compression
+  std::vector<u8>* src = nullptr;
+  std::vector<u8>* dst = nullptr;
+};
 
-  const char jak2_header[] = "oZlB";
-  bool is_jak2 = true;
-  for (int i = 0; i < 4; i++) {
-    if (jak2_header[i] != dgo_data[i]) {
-      is_jak2 = false;
-    }
-  }
+/*!
+ * An object file inside a DGO, before it is added to the ObjectFileDB.
+ */
+struct DgoObjectEntry {
+  std::string name;
+  std::string name_in_dgo;
+  uint32_t offset = 0;
+  uint32_t size = 0;
+  uint32_t hash = 0;
+  bool allowed = true;
+};
 
-  if (is_jak2) {
-    BinaryReader compressed_reader(dgo_data);
-    // seek past oZlB
-    compressed_reader.ffwd(4);
-    std::size_t decompressed_size = compressed_reader.read<uint32_t>();
-    std::vector<uint8_t> decompressed_data;
-    decompressed_data.resize(decompressed_size);
-    size_t output_offset = 0;
-    while (true) {
-      // seek past alignment bytes and read the next chunk size
-      uint32_t chunk_size = 0;
-      while (!chunk_size) {
-        chunk_size = compressed_reader.read<uint32_t>();
-      }
+/*!
+ * A DGO file which has been read from the disk.
+ */
+struct LoadedDgo {
+  std::string filename;
+  std::vector<u8> compressed_data;  // only used for Jak 2.
+  std::vector<u8> data;
+  std::vector<DgoChunk> chunks;
+  std::vector<DgoObjectEntry> objects;
+};
 
-      if (chunk_size < MAX_CHUNK_SIZE) {
-        std::size_t bytes_written = 0;
-        lzokay::EResult ok = lzokay::decompress(
-            compressed_reader.here(), chunk_size, decompressed_data.data() + output_offset,
-            decompressed_data.size() - output_offset, bytes_written);
-        assert(ok == lzokay::EResult::Success);
-        compressed_reader.ffwd(chunk_size);
-        output_offset += bytes_written;
-      } else {
-        // nope - sometimes chunk_size is bigger than MAX, but we should still use max.
-        //        assert(chunk_size == MAX_CHUNK_SIZE);
-        memcpy(decompressed_data.data() + output_offset, compressed_reader.here(), MAX_CHUNK_SIZE);
-        compressed_reader.ffwd(MAX_CHUNK_SIZE);
-        output_offset += MAX_CHUNK_SIZE;
-      }
+/*!
+ * Figure out where each chunk of a Jak 2 compressed DGO goes. Every chunk except the last one
+ * decompresses to MAX_CHUNK_SIZE bytes, so each chunk's location in the output is known up front
+ * and chunks can be decompressed independently.
+ */
+void find_jak2_dgo_chunks(LoadedDgo& dgo) {
+  BinaryReader compressed_reader(dgo.compressed_data);
+  // seek past oZlB
+  compressed_reader.ffwd(4);
+  std::size_t decompressed_size = compressed_reader.read<uint32_t>();
+  dgo.data.resize(decompressed_size);
+  size_t output_offset = 0;
+  while (true) {
+    // seek past alignment bytes and read the next chunk size
+    uint32_t chunk_size = 0;
+    while (!chunk_size) {
+      chunk_size = compressed_reader.read<uint32_t>();
+    }
 
-      if (output_offset >= decompressed_size)
-        break;
-      while (compressed_reader.get_seek() % 4) {
-        compressed_reader.ffwd(1);
-      }
+    DgoChunk chunk;
+    chunk.src = &dgo.compressed_data;
+    chunk.dst = &dgo.data;
+    chunk.src_offset = compressed_reader.get_seek();
+    chunk.dst_offset = output_offset;
+    chunk.dst_size = std::min(size_t(MAX_CHUNK_SIZE), decompressed_size - output_offset);
+    if (chunk_size < MAX_CHUNK_SIZE) {
+      chunk.compressed = true;
+      chunk.src_size = chunk_size;
+    } else {
+      // nope - sometimes chunk_size is bigger than MAX, but we should still use max.
+      //        assert(chunk_size == MAX_CHUNK_SIZE);
+      chunk.src_size = MAX_CHUNK_SIZE;
+    }
+    compressed_reader.ffwd(chunk.src_size);
+    output_offset += chunk.dst_size;
+    dgo.chunks.push_back(chunk);
+
+    if (output_offset >= decompressed_size)
+      break;
+    while (compressed_reader.get_seek() % 4) {
+      compressed_reader.ffwd(1);
     }
-    dgo_data = decompressed_data;
   }
+}
 
-  BinaryReader reader(dgo_data);
+/*!
+ * Decompress (or copy) a single chunk directly into the decompressed DGO.
+ */
+void decompress_dgo_chunk(const DgoChunk& chunk) {
+  assert(chunk.src_offset + chunk.src_size <= chunk.src->size());
+  assert(chunk.dst_offset + chunk.dst_size <= chunk.dst->size());
+  if (chunk.compressed) {
+    std::size_t bytes_written = 0;
+    lzokay::EResult ok =
+        lzokay::decompress(chunk.src->data() + chunk.src_offset, chunk.src_size,
+                           chunk.dst->data() + chunk.dst_offset, chunk.dst_size, bytes_written);
+    assert(ok == lzokay::EResult::Success);
+    assert(bytes_written == chunk.dst_size);
+  } else {
+    memcpy(chunk.dst->data() + chunk.dst_offset, chunk.src->data() + chunk.src_offset,
+           chunk.dst_size);
+  }
+}
+
+/*!
+ * Find all object files in a decompressed DGO, figure out their names, and hash them.
+ */
+void find_dgo_objects(LoadedDgo& dgo) {
+  BinaryReader reader(dgo.data);
   auto header = reader.read<DgoHeader>();
 
-  auto dgo_base_name = file_util::base_name(filename);
+  auto dgo_base_name = file_util::base_name(dgo.filename);
   assert(header.name == dgo_base_name);
   assert_string_empty_after(header.name, 60);
 
+  const auto& config = get_config();
+
   // get all obj files...
   for (uint32_t i = 0; i < header.object_count; i++) {
     auto obj_header = reader.read<DgoHeader>();
@@ -264,15 +320,88 @@ void ObjectFileDB::get_objs_from_dgo(const std::string& filename) {
       assert(false);
     }
 
-    auto name = get_object_file_name(obj_header.name, reader.here(), obj_header.object_count);
-
-    add_obj_from_dgo(name, obj_header.name, reader.here(), obj_header.object_count, dgo_base_name);
+    DgoObjectEntry entry;
+    entry.offset = reader.get_seek();
+    entry.size = obj_header.object_count;
+    u8* obj_data = dgo.data.data() + entry.offset;
+    entry.name = get_object_file_name(obj_header.name, obj_data, entry.size);
+    entry.name_in_dgo = obj_header.name;
+    if (!config.allowed_objects.empty() &&
+        config.allowed_objects.find(entry.name) == config.allowed_objects.end()) {
+      entry.allowed = false;
+    } else {
+      entry.hash = file_util::crc32(obj_data, entry.size);
+    }
+    dgo.objects.push_back(entry);
     reader.ffwd(obj_header.object_count);
   }
 
   // check we're at the end
   assert(0 == reader.bytes_left());
 }
+}  // namespace
+
+/*!
+ * Load the objects stored in the given DGOs into the ObjectFileDB.
+ * Reading, decompressing, naming and hashing happen in parallel, then objects are added to the
+ * database in the order of the DGO list so deduplication and naming don't depend on timing.
+ */
+void ObjectFileDB::get_objs_from_dgos(const std::vector<std::string>& filenames) {
+  std::vector<LoadedDgo> dgos(filenames.size());
+
+  // read files and find the chunks of compressed DGOs
+  parallel_for(dgos.size(), [&](size_t i) {
+    auto& dgo = dgos.at(i);
+    dgo.filename = filenames.at(i);
+    auto file_data = file_util::read_binary_file(dgo.filename);
+
+    const char jak2_header[] = "oZlB";
+    bool is_jak2 = file_data.size() >= 4;
+    for (int j = 0; is_jak2 && j < 4; j++) {
+      if (jak2_header[j] != file_data[j]) {
+        is_jak2 = false;
+      }
+    }
+
+    if (is_jak2) {
+      dgo.compressed_data = std::move(file_data);
+      find_jak2_dgo_chunks(dgo);
+    } else {
+      dgo.data = std::move(file_data);
+    }
+  });
+
+  for (auto& dgo : dgos) {
+    stats.total_dgo_bytes +=
+        dgo.compressed_data.empty() ? dgo.data.size() : dgo.compressed_data.size();
+  }
+
+  // decompress all chunks of all DGOs together, so a single big DGO is still split up.
+  std::vector<DgoChunk> all_chunks;
+  for (auto& dgo : dgos) {
+    all_chunks.insert(all_chunks.end(), dgo.chunks.begin(), dgo.chunks.end());
+  }
+  parallel_for(all_chunks.size(), [&](size_t i) { decompress_dgo_chunk(all_chunks.at(i)); });
+
+  parallel_for(dgos.size(), [&](size_t i) {
+    auto& dgo = dgos.at(i);
+    std::vector<u8>().swap(dgo.compressed_data);
+    find_dgo_objects(dgo);
+  });
+
+  // add to the database in order. This does the deduplication by hash.
+  for (auto& dgo : dgos) {
+    auto dgo_base_name = file_util::base_name(dgo.filename);
+    for (auto& obj : dgo.objects) {
+      if (!obj.allowed) {
+        continue;
+      }
+      add_obj_from_dgo(obj.name, obj.name_in_dgo, dgo.data.data() + obj.offset, obj.size,
+                       dgo_base_name, obj.hash);
+    }
+    std::vector<u8>().swap(dgo.data);
+  }
+}
 
 /*!
  * Add an object file to the ObjectFileDB
@@ -288,10 +417,23 @@ void ObjectFileDB::add_obj_from_dgo(const std::string& obj_name,
       return;
     }
   }
+  add_obj_from_dgo(obj_name, name_in_dgo, obj_data, obj_size, dgo_name,
+                   file_util::crc32(obj_data, obj_size));
+}
+
+/*!
+ * Add an object file to the ObjectFileDB, using an already computed hash.
+ * Does not check the allowed_objects list.
+ */
+void ObjectFileDB::add_obj_from_dgo(const std::string& obj_name,
+                                    const std::string& name_in_dgo,
+                                    const uint8_t* obj_data,
+                                    uint32_t obj_size,
+                                    const std::string& dgo_name,
+                                    uint32_t hash) {
   stats.total_obj_files++;
   assert(obj_size > 128);
   uint16_t version = *(const uint16_t*)(obj_data + 8);
-  auto hash = file_util::crc32(obj_data, obj_size);
 
   bool duplicated = false;
   // first, check to see if we already got it...
@@ -468,11 +610,14 @@ void ObjectFileDB::write_object_file_words(const std::string& output_dir, bool d
   }
 
   Timer timer;
-  uint32_t total_bytes = 0, total_files = 0;
+  std::atomic<uint32_t> total_bytes = {0}, total_files = {0};
 
-  for_each_obj([&](ObjectFileData& obj) {
+  for_each_obj_parallel([&](ObjectFileData& obj) {
     if (obj.linked_data.segments == 3 || !dump_v3_only) {
-      auto file_text = obj.linked_data.print_words();
+      // each thread reuses its own buffer, so we don't reallocate for every file.
+      thread_local std::string file_text;
+      file_text.clear();
+      obj.linked_data.append_words_to_string(file_text);
       auto file_name = file_util::combine_path(output_dir, obj.to_unique_name() + ".txt");
       total_bytes += file_text.size();
       file_util::write_text_file(file_name, file_text);
@@ -481,10 +626,10 @@ void ObjectFileDB::write_object_file_words(const std::string& output_dir, bool d
   });
 
   lg::info("Wrote object file dumps:");
-  lg::info(" Total {} files", total_files);
-  lg::info(" Total {:.3f} MB", total_bytes / ((float)(1u << 20u)));
+  lg::info(" Total {} files", total_files.load());
+  lg::info(" Total {:.3f} MB", total_bytes.load() / ((float)(1u << 20u)));
   lg::info(" Total {} ms ({:.3f} MB/sec)", timer.getMs(),
-           total_bytes / ((1u << 20u) * timer.getSeconds()));
+           total_bytes.load() / ((1u << 20u) * timer.getSeconds()));
   // printf("\n");
 }
 
@@ -497,14 +642,23 @@ void ObjectFileDB::write_disassembly(const std::string& output_dir,
                                      const std::string& file_suffix) {
   lg::info("- Writing functions...");
   Timer timer;
-  uint32_t total_bytes = 0, total_files = 0;
+  std::atomic<uint32_t> total_bytes = {0}, total_files = {0};
 
-  std::string asm_functions;
+  // asm functions are collected per object, then combined in order.
+  std::unordered_map<const ObjectFileData*, std::string> asm_functions_by_obj;
+  std::mutex asm_functions_mutex;
 
-  for_each_obj([&](ObjectFileData& obj) {
+  for_each_obj_parallel([&](ObjectFileData& obj) {
     if (obj.linked_data.has_any_functions() || disassemble_objects_without_functions) {
-      auto file_text = obj.linked_data.print_disassembly();
-      asm_functions += obj.linked_data.print_asm_function_disassembly(obj.to_unique_name());
+      // each thread reuses its own buffer, so we don't reallocate for every file.
+      thread_local std::string file_text;
+      file_text.clear();
+      obj.linked_data.append_disassembly_to_string(file_text);
+      auto asm_text = obj.linked_data.print_asm_function_disassembly(obj.to_unique_name());
+      {
+        std::lock_guard<std::mutex> lock(asm_functions_mutex);
+        asm_functions_by_obj[&obj] = std::move(asm_text);
+      }
       auto file_name =
           file_util::combine_path(output_dir, obj.to_unique_name() + file_suffix + ".asm");
 
@@ -523,16 +677,24 @@ void ObjectFileDB::write_disassembly(const std::string& output_dir,
     }
   });
 
+  std::string asm_functions;
+  for_each_obj([&](ObjectFileData& obj) {
+    auto kv = asm_functions_by_obj.find(&obj);
+    if (kv != asm_functions_by_obj.end()) {
+      asm_functions += kv->second;
+    }
+  });
+
   total_bytes += asm_functions.size();
   total_files++;
   file_util::write_text_file(file_util::combine_path(output_dir, "asm_functions.func"),
                              asm_functions);
 
   lg::info("Wrote functions dumps:");
-  lg::info(" Total {} files", total_files);
-  lg::info(" Total {} MB", total_bytes / ((float)(1u << 20u)));
+  lg::info(" Total {} files", total_files.load());
+  lg::info(" Total {} MB", total_bytes.load() / ((float)(1u << 20u)));
   lg::info(" Total {} ms ({:.3f} MB/sec)", timer.getMs(),
-           total_bytes / ((1u << 20u) * timer.getSeconds()));
+           total_bytes.load() / ((1u << 20u) * timer.getSeconds()));
 }
 
 /*!
@@ -605,16 +767,17 @@ void ObjectFileDB::find_and_write_scripts(const std::string& output_dir) {
 void ObjectFileDB::process_tpages() {
   lg::info("- Finding textures in tpages...");
   std::string tpage_string = "tpage-";
-  int total = 0, success = 0;
+  std::atomic<int> total = {0}, success = {0};
   Timer timer;
-  for_each_obj([&](ObjectFileData& data) {
-    if (data.name_in_dgo.substr(0, tpage_string.length()) == tpage_string) {
+  // each tpage is independent, so they can be processed in parallel.
+  for_each_obj_parallel([&](ObjectFileData& data) {
+    if (data.name_in_dgo.compare(0, tpage_string.length(), tpage_string) == 0) {
       auto statistics = process_tpage(data);
       total += statistics.total_textures;
       success += statistics.successful_textures;
     }
   });
-  lg::info("Processed {} / {} textures {:.2f}% in {:.2f} ms", success, total,
+  lg::info("Processed {} / {} textures {:.2f}% in {:.2f} ms", success.load(), total.load(),
            100.f * float(success) / float(total), timer.getMs());
 }
 
@@ -17,6 +17,7 @@
 #include "LinkedObjectFile.h"
 #include "decompiler/util/DecompilerTypeSystem.h"
 #include "common/common_types.h"
+#include "common/util/parallel_for.h"
 
 namespace decompiler {
 /*!
@@ -76,9 +77,9 @@ class ObjectFileDB {
   void ir2_store_current_forms();
   void ir2_build_expressions();
   void ir2_write_results(const std::string& output_dir);
-  std::string ir2_to_file(ObjectFileData& data);
-  std::string ir2_function_to_string(ObjectFileData& data, Function& function, int seg);
-  std::string ir2_final_out(ObjectFileData& data);
+  void ir2_to_file(ObjectFileData& data, std::string& result);
+  void ir2_append_function(ObjectFileData& data, Function& function, int seg, std::string& result);
+  void ir2_final_out(ObjectFileData& data, std::string& result);
 
   void process_tpages();
   std::string process_game_count_file();
@@ -94,12 +95,18 @@ class ObjectFileDB {
 
  public:
   void load_map_file(const std::string& map_data);
-  void get_objs_from_dgo(const std::string& filename);
+  void get_objs_from_dgos(const std::vector<std::string>& filenames);
   void add_obj_from_dgo(const std::string& obj_name,
                         const std::string& name_in_dgo,
                         const uint8_t* obj_data,
                         uint32_t obj_size,
                         const std::string& dgo_name);
+  void add_obj_from_dgo(const std::string& obj_name,
+                        const std::string& name_in_dgo,
+                        const uint8_t* obj_data,
+                        uint32_t obj_size,
+                        const std::string& dgo_name,
+                        uint32_t hash);
 
   /*!
    * Apply f to all ObjectFileData's. Does it in the right order.
@@ -114,6 +121,22 @@ class ObjectFileDB {
     }
   }
 
+  /*!
+   * Apply f to all ObjectFileData's, using multiple threads. The order is not defined, so f
+   * should only modify the object it is given.
+   */
+  template <typename Func>
+  void for_each_obj_parallel(Func f) {
+    assert(obj_files_by_name.size() == obj_file_order.size());
+    std::vector<ObjectFileData*> objs;
+    for (const auto& name : obj_file_order) {
+      for (auto& obj : obj_files_by_name.at(name)) {
+        objs.push_back(&obj);
+      }
+    }
+    parallel_for(objs.size(), [&](size_t i) { f(*objs.at(i)); });
+  }
+
   /*!
    * Apply f to all functions
    * takes (Function, segment, linked_data)
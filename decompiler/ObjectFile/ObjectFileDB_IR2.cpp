@@ -3,11 +3,13 @@
  * This runs the IR2 analysis passes.
  */
 
+#include <atomic>
 #include <common/link_types.h>
 #include "ObjectFileDB.h"
 #include "common/log/log.h"
 #include "common/util/Timer.h"
 #include "common/util/FileUtil.h"
+#include "common/util/parallel_for.h"
 #include "decompiler/Function/TypeInspector.h"
 #include "decompiler/analysis/reg_usage.h"
 #include "decompiler/analysis/variable_naming.h"
@@ -270,7 +272,18 @@ void ObjectFileDB::ir2_type_analysis_pass() {
   int total_functions = 0;
   int non_asm_functions = 0;
   int attempted_functions = 0;
-  int successful_functions = 0;
+  std::atomic<int> successful_functions = {0};
+
+  // first find the functions to analyze and set up their settings. This reads the config and
+  // looks up function types, so it's done on a single thread.
+  struct TypeAnalysisTask {
+    Function* func = nullptr;
+    LinkedObjectFile* file = nullptr;
+    const std::unordered_map<int, std::vector<TypeHint>>* hints = nullptr;
+  };
+  std::vector<TypeAnalysisTask> tasks;
+  const auto& config = get_config();
+  const std::unordered_map<int, std::vector<TypeHint>> no_hints;
 
   for_each_function_def_order([&](Function& func, int segment_id, ObjectFileData& data) {
     (void)segment_id;
@@ -281,13 +294,20 @@ void ObjectFileDB::ir2_type_analysis_pass() {
       if (lookup_function_type(func.guessed_name, data.to_unique_name(), &ts)) {
         func.type = ts;
         attempted_functions++;
-        // try type analysis here.
-        auto hints = get_config().type_hints_by_function_by_idx[func.guessed_name.to_string()];
-        if (func.run_type_analysis_ir2(ts, dts, data.linked_data, hints)) {
-          successful_functions++;
-        } else {
-          func.warnings.append(";; Type analysis failed\n");
+        auto name = func.guessed_name.to_string();
+        // in config we can manually specify some settings for type propagation to reduce the
+        // strictness of type propagation.
+        if (config.pair_functions_by_name.find(name) != config.pair_functions_by_name.end()) {
+          func.ir2.env.set_sloppy_pair_typing();
+        }
+        if (func.guessed_name.kind == FunctionName::FunctionKind::METHOD) {
+          func.ir2.env.set_method_type(func.guessed_name.type_name);
         }
+        auto hints_kv = config.type_hints_by_function_by_idx.find(name);
+        tasks.push_back({&func, &data.linked_data,
+                         hints_kv == config.type_hints_by_function_by_idx.end()
+                             ? &no_hints
+                             : &hints_kv->second});
       } else {
         // lg::warn("Function {} didn't know its type", func.guessed_name.to_string());
         func.warnings.append(";; Type of function is unknown\n");
@@ -295,8 +315,20 @@ void ObjectFileDB::ir2_type_analysis_pass() {
     }
   });
 
-  lg::info("{}/{}/{}/{} (success/attempted/non-asm/total) in {:.2f} ms\n", successful_functions,
-           attempted_functions, non_asm_functions, total_functions, timer.getMs());
+  // then run type analysis. Functions don't share any mutable state, so they can run in parallel.
+  parallel_for(tasks.size(), [&](size_t i) {
+    auto& task = tasks.at(i);
+    auto& func = *task.func;
+    if (func.run_type_analysis_ir2(func.type, dts, *task.file, *task.hints)) {
+      successful_functions++;
+    } else {
+      func.warnings.append(";; Type analysis failed\n");
+    }
+  });
+
+  lg::info("{}/{}/{}/{} (success/attempted/non-asm/total) in {:.2f} ms\n",
+           successful_functions.load(), attempted_functions, non_asm_functions, total_functions,
+           timer.getMs());
 }
 
 void ObjectFileDB::ir2_register_usage_pass() {
@@ -408,29 +440,34 @@ void ObjectFileDB::ir2_build_expressions() {
 void ObjectFileDB::ir2_write_results(const std::string& output_dir) {
   Timer timer;
   lg::info("Writing IR2 results to file...");
-  int total_files = 0;
-  int total_bytes = 0;
-  for_each_obj([&](ObjectFileData& obj) {
+  std::atomic<int> total_files = {0};
+  std::atomic<size_t> total_bytes = {0};
+  for_each_obj_parallel([&](ObjectFileData& obj) {
     if (obj.linked_data.has_any_functions()) {
-      // todo
+      // each thread reuses its own buffer, so we don't reallocate for every file.
+      thread_local std::string buffer;
       total_files++;
-      auto file_text = ir2_to_file(obj);
-      total_bytes += file_text.length();
+      buffer.clear();
+      ir2_to_file(obj, buffer);
+      total_bytes += buffer.length();
       auto file_name = file_util::combine_path(output_dir, obj.to_unique_name() + "_ir2.asm");
-      file_util::write_text_file(file_name, file_text);
+      file_util::write_text_file(file_name, buffer);
 
-      auto final = ir2_final_out(obj);
+      buffer.clear();
+      ir2_final_out(obj, buffer);
+      total_bytes += buffer.length();
       auto final_name = file_util::combine_path(output_dir, obj.to_unique_name() + "_disasm.gc");
-      file_util::write_text_file(final_name, final);
+      file_util::write_text_file(final_name, buffer);
     }
   });
-  lg::info("Wrote {} files ({:.2f} MB) in {:.2f} ms\n", total_files, total_bytes / float(1 << 20),
-           timer.getMs());
+  lg::info("Wrote {} files ({:.2f} MB) in {:.2f} ms\n", total_files.load(),
+           total_bytes.load() / float(1 << 20), timer.getMs());
 }
 
-std::string ObjectFileDB::ir2_to_file(ObjectFileData& data) {
-  std::string result;
-
+/*!
+ * Print the IR2 debug output for an object file to the end of result.
+ */
+void ObjectFileDB::ir2_to_file(ObjectFileData& data, std::string& result) {
   const char* segment_names[] = {"main segment", "debug segment", "top-level segment"};
   assert(data.linked_data.segments <= 3);
   for (int seg = data.linked_data.segments; seg-- > 0;) {
@@ -441,7 +478,7 @@ std::string ObjectFileDB::ir2_to_file(ObjectFileData& data) {
 
     // functions
     for (auto& func : data.linked_data.functions_by_seg.at(seg)) {
-      result += ir2_function_to_string(data, func, seg);
+      ir2_append_function(data, func, seg, result);
       if (func.ir2.top_form && func.ir2.env.has_local_vars()) {
         result += '\n';
         if (func.ir2.env.has_local_vars()) {
@@ -487,8 +524,6 @@ std::string ObjectFileDB::ir2_to_file(ObjectFileData& data) {
       }
     }
   }
-
-  return result;
 }
 
 namespace {
@@ -525,8 +560,10 @@ void append_commented(std::string& line,
 }
 }  // namespace
 
-std::string ObjectFileDB::ir2_function_to_string(ObjectFileData& data, Function& func, int seg) {
-  std::string result;
+void ObjectFileDB::ir2_append_function(ObjectFileData& data,
+                                       Function& func,
+                                       int seg,
+                                       std::string& result) {
   result += ";;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;\n";
   result += "; .function " + func.guessed_name.to_string() + "\n";
   result += ";;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;\n";
@@ -670,7 +707,6 @@ std::string ObjectFileDB::ir2_function_to_string(ObjectFileData& data, Function&
   result += "\n";
 
   assert(total_instructions_printed == (func.end_word - func.start_word - 1));
-  return result;
 }
 
 /*!
@@ -735,18 +771,19 @@ bool ObjectFileDB::lookup_function_type(const FunctionName& name,
   return false;
 }
 
-std::string ObjectFileDB::ir2_final_out(ObjectFileData& data) {
+/*!
+ * Print the final decompiler output for an object file to the end of result.
+ */
+void ObjectFileDB::ir2_final_out(ObjectFileData& data, std::string& result) {
   if (data.obj_version == 3) {
-    std::string result;
     result += ";;-*-Lisp-*-\n";
     result += "(in-package goal)\n\n";
     assert(data.linked_data.functions_by_seg.at(TOP_LEVEL_SEGMENT).size() == 1);
-    auto top_level = data.linked_data.functions_by_seg.at(TOP_LEVEL_SEGMENT).at(0);
+    const auto& top_level = data.linked_data.functions_by_seg.at(TOP_LEVEL_SEGMENT).at(0);
     result += write_from_top_level(top_level, dts, data.linked_data);
     result += "\n\n";
-    return result;
   } else {
-    return ";; not a code file.";
+    result += ";; not a code file.";
   }
 }
 
@@ -318,11 +318,9 @@ bool try_clean_up_sc_as_and(FormPool& pool, Function& func, ShortCircuitElement*
       }
 
       if (i == 0) {
-        live_out_result = (branch_info.written_and_unused.find(ir_dest.reg()) ==
-                           branch_info.written_and_unused.end());
+        live_out_result = !branch_info.written_and_unused.contains(ir_dest.reg());
       } else {
-        bool this_live_out = (branch_info.written_and_unused.find(ir_dest.reg()) ==
-                              branch_info.written_and_unused.end());
+        bool this_live_out = !branch_info.written_and_unused.contains(ir_dest.reg());
         if (live_out_result != this_live_out) {
           lg::error("Bad live out result on {}. At 0 was {} now at {} is {}",
                     func.guessed_name.to_string(), live_out_result, i, this_live_out);
@@ -386,11 +384,9 @@ bool try_clean_up_sc_as_or(FormPool& pool, Function& func, ShortCircuitElement*
       }
 
       if (i == 0) {
-        live_out_result = (delay_info.written_and_unused.find(ir_dest.reg()) ==
-                           delay_info.written_and_unused.end());
+        live_out_result = !delay_info.written_and_unused.contains(ir_dest.reg());
       } else {
-        bool this_live_out = (delay_info.written_and_unused.find(ir_dest.reg()) ==
-                              delay_info.written_and_unused.end());
+        bool this_live_out = !delay_info.written_and_unused.contains(ir_dest.reg());
         assert(live_out_result == this_live_out);
       }
     }
@@ -572,8 +568,8 @@ void clean_up_cond_no_else_final(const Function& func, CondNoElseElement* cne) {
 
   if (func.ir2.env.has_reg_use()) {
     auto& last_branch_info = func.ir2.env.reg_use().op.at(last_branch->op()->op_id());
-    cne->used_as_value = last_branch_info.written_and_unused.find(cne->final_destination.reg()) ==
-                         last_branch_info.written_and_unused.end();
+    cne->used_as_value =
+        !last_branch_info.written_and_unused.contains(cne->final_destination.reg());
   }
 
   // check that all other delay slot writes are unused.
@@ -584,8 +580,7 @@ void clean_up_cond_no_else_final(const Function& func, CondNoElseElement* cne) {
       auto reg = cne->entries.at(i).false_destination;
       assert(reg.has_value());
       assert(branch);
-      assert(branch_info_i.written_and_unused.find(reg->reg()) !=
-             branch_info_i.written_and_unused.end());
+      assert(branch_info_i.written_and_unused.contains(reg->reg()));
     }
   }
 }
@@ -1277,7 +1272,7 @@ void convert_and_inline(FormPool& pool, Function& f, const BlockVtx* as_block, T
 void insert_cfg_into_list(FormPool& pool,
                           Function& f,
                           const CfgVtx* vtx,
-                          std::vector<FormElement*>* output) {
+                          Form::ElementList* output) {
   auto as_sequence = dynamic_cast<const SequenceVtx*>(vtx);
   auto as_block = dynamic_cast<const BlockVtx*>(vtx);
   if (as_sequence) {
@@ -1518,9 +1513,11 @@ void build_initial_forms(Function& function) {
   try {
     auto& pool = function.ir2.form_pool;
     auto top_level = function.cfg->get_single_top_level();
-    std::vector<FormElement*> top_level_elts;
-    insert_cfg_into_list(*pool, function, top_level, &top_level_elts);
-    auto result = pool->alloc_sequence_form(nullptr, top_level_elts);
+    auto result = pool->alloc_empty_form();
+    insert_cfg_into_list(*pool, function, top_level, &result->elts());
+    for (auto x : result->elts()) {
+      x->parent_form = result;
+    }
 
     result->apply_form([&](Form* form) { clean_up_while_loops(*pool, form, function.ir2.env); });
 
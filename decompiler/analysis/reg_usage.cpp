@@ -8,62 +8,39 @@ RegUsageInfo::RegUsageInfo(int n_blocks, int n_ops) {
 }
 
 namespace {
-bool in_set(RegSet& set, const Register& obj) {
-  return set.find(obj) != set.end();
+RegSet to_set(const std::vector<Register>& regs) {
+  RegSet result;
+  for (auto& x : regs) {
+    result.insert(x);
+  }
+  return result;
 }
 
 void phase1(const FunctionAtomicOps& ops, int block_id, RegUsageInfo* out) {
   int end_op = ops.block_id_to_end_atomic_op.at(block_id);
   int start_op = ops.block_id_to_first_atomic_op.at(block_id);
+  auto& block = out->block.at(block_id);
 
   for (int i = end_op; i-- > start_op;) {
     const auto& instr = ops.ops.at(i);
-    auto read = instr->read_regs();
-    auto write = instr->write_regs();
 
     auto& lv = out->op.at(i).live;
     auto& dd = out->op.at(i).dead;
-    auto& block = out->block.at(block_id);
 
     // make all read live out
-    lv.clear();
-    for (auto& x : read) {
-      lv.insert(x);
-    }
+    lv = to_set(instr->read_regs());
 
     // kill things which are overwritten
-    dd.clear();
-    for (auto& x : write) {
-      if (!in_set(lv, x)) {
-        dd.insert(x);
-      }
-    }
+    dd = to_set(instr->write_regs());
+    dd -= lv;
 
-    // b.use = i.liveout
-    RegSet use_old = block.use;
-    block.use.clear();
-    for (auto& x : lv) {
-      block.use.insert(x);
-    }
-    // | (bu.use & !i.dead)
-    for (auto& x : use_old) {
-      if (!in_set(dd, x)) {
-        block.use.insert(x);
-      }
-    }
+    // b.use = i.liveout | (bu.use & !i.dead)
+    block.use -= dd;
+    block.use |= lv;
 
-    // b.defs = i.dead
-    RegSet defs_old = block.defs;
-    block.defs.clear();
-    for (auto& x : dd) {
-      block.defs.insert(x);
-    }
-    // | b.defs & !i.lv
-    for (auto& x : defs_old) {
-      if (!in_set(lv, x)) {
-        block.defs.insert(x);
-      }
-    }
+    // b.defs = i.dead | b.defs & !i.lv
+    block.defs -= lv;
+    block.defs |= dd;
   }
 }
 
@@ -77,17 +54,12 @@ bool phase2(const std::vector<BasicBlock>& blocks, int block_id, RegUsageInfo* i
     if (s == -1) {
       continue;
     }
-    for (auto in : info->block.at(s).input) {
-      out.insert(in);
-    }
+    out |= info->block.at(s).input;
   }
 
-  RegSet in = block_info.use;
-  for (auto x : out) {
-    if (!in_set(block_info.defs, x)) {
-      in.insert(x);
-    }
-  }
+  RegSet in = out;
+  in -= block_info.defs;
+  in |= block_info.use;
 
   if (in != block_info.input || out != block_info.output) {
     changed = true;
@@ -108,9 +80,7 @@ void phase3(const FunctionAtomicOps& ops,
     if (s == -1) {
       continue;
     }
-    for (auto i : info->block.at(s).input) {
-      live_local.insert(i);
-    }
+    live_local |= info->block.at(s).input;
   }
 
   int end_op = ops.block_id_to_end_atomic_op.at(block_id);
@@ -120,12 +90,9 @@ void phase3(const FunctionAtomicOps& ops,
     auto& lv = info->op.at(i).live;
     auto& dd = info->op.at(i).dead;
 
-    RegSet new_live = lv;
-    for (auto x : live_local) {
-      if (!in_set(dd, x)) {
-        new_live.insert(x);
-      }
-    }
+    RegSet new_live = live_local;
+    new_live -= dd;
+    new_live |= lv;
     lv = live_local;
     live_local = new_live;
   }
@@ -141,10 +108,12 @@ RegUsageInfo analyze_ir2_register_usage(const Function& function) {
     phase1(*ops, i, &result);
   }
 
+  // liveness flows backward, so visiting blocks in reverse order usually settles in fewer passes.
+  // the fixed point is the same in any order.
   bool changed = false;
   do {
     changed = false;
-    for (int i = 0; i < int(blocks.size()); i++) {
+    for (int i = int(blocks.size()); i-- > 0;) {
       if (phase2(blocks, i, &result)) {
         changed = true;
       }
@@ -163,32 +132,26 @@ RegUsageInfo analyze_ir2_register_usage(const Function& function) {
   for (int i = 0; i < int(ops->ops.size()); i++) {
     const auto& op = ops->ops.at(i);
     auto& op_info = result.op.at(i);
+    auto written = to_set(op->write_regs());
 
     // look at each register we read from:
     for (auto reg : op->read_regs()) {
-      if (op_info.live.find(reg) == op_info.live.end()) {
+      if (!op_info.live.contains(reg)) {
         // not live out, this means we must consume it.
         op_info.consumes.insert(reg);
-      } else {
-        // the register has a live value, but is it a new value?
-        for (auto wr : op->write_regs()) {
-          if (wr == reg) {
-            op_info.consumes.insert(reg);
-          }
-        }
+      } else if (written.contains(reg)) {
+        // the register has a live value, but it's a new value.
+        op_info.consumes.insert(reg);
       }
     }
 
     // also useful to know, written and unused.
-    for (auto reg : op->write_regs()) {
-      if (op_info.live.find(reg) == op_info.live.end()) {
-        op_info.written_and_unused.insert(reg);
-      }
-    }
+    op_info.written_and_unused = written;
+    op_info.written_and_unused -= op_info.live;
   }
 
   result.op.pop_back();
   assert(result.op.size() == ops->ops.size());
   return result;
 }
-}  // namespace decompiler
\ No newline at end of file
+}  // namespace decompiler
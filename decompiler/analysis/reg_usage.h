@@ -1,14 +1,149 @@
 #pragma once
 
+#include <bitset>
+#include <cassert>
 #include <vector>
-#include <unordered_set>
+#include "common/common_types.h"
 #include "decompiler/Disasm/Register.h"
 
 namespace decompiler {
 
 class Function;
 
-using RegSet = std::unordered_set<Register, Register::hash>;
+/*!
+ * A set of registers, stored as a bitset with one bit per register.
+ * Iterating goes in order of register kind, then register number.
+ */
+class RegSet {
+ public:
+  class Iterator {
+   public:
+    Iterator(const RegSet* set, int idx) : m_set(set), m_idx(idx) {}
+    Register operator*() const { return reg_from_idx(m_idx); }
+    Iterator& operator++() {
+      m_idx = m_set->next_idx(m_idx + 1);
+      return *this;
+    }
+    bool operator==(const Iterator& other) const { return m_idx == other.m_idx; }
+    bool operator!=(const Iterator& other) const { return m_idx != other.m_idx; }
+
+   private:
+    const RegSet* m_set = nullptr;
+    int m_idx = 0;
+  };
+
+  void insert(Register reg) { m_bits[idx_of(reg) / 64] |= (u64(1) << (idx_of(reg) % 64)); }
+  void erase(Register reg) { m_bits[idx_of(reg) / 64] &= ~(u64(1) << (idx_of(reg) % 64)); }
+  bool contains(Register reg) const {
+    return m_bits[idx_of(reg) / 64] & (u64(1) << (idx_of(reg) % 64));
+  }
+
+  void clear() {
+    for (auto& word : m_bits) {
+      word = 0;
+    }
+  }
+
+  bool empty() const {
+    for (auto word : m_bits) {
+      if (word) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  int size() const {
+    int result = 0;
+    for (auto word : m_bits) {
+      result += std::bitset<64>(word).count();
+    }
+    return result;
+  }
+
+  // union
+  RegSet& operator|=(const RegSet& other) {
+    for (int i = 0; i < WORD_COUNT; i++) {
+      m_bits[i] |= other.m_bits[i];
+    }
+    return *this;
+  }
+
+  // intersection
+  RegSet& operator&=(const RegSet& other) {
+    for (int i = 0; i < WORD_COUNT; i++) {
+      m_bits[i] &= other.m_bits[i];
+    }
+    return *this;
+  }
+
+  // difference, remove everything in other.
+  RegSet& operator-=(const RegSet& other) {
+    for (int i = 0; i < WORD_COUNT; i++) {
+      m_bits[i] &= ~other.m_bits[i];
+    }
+    return *this;
+  }
+
+  bool intersects(const RegSet& other) const {
+    for (int i = 0; i < WORD_COUNT; i++) {
+      if (m_bits[i] & other.m_bits[i]) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool operator==(const RegSet& other) const {
+    for (int i = 0; i < WORD_COUNT; i++) {
+      if (m_bits[i] != other.m_bits[i]) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  bool operator!=(const RegSet& other) const { return !((*this) == other); }
+
+  Iterator begin() const { return Iterator(this, next_idx(0)); }
+  Iterator end() const { return Iterator(this, BIT_COUNT); }
+
+ private:
+  static constexpr int REGS_PER_KIND = 32;
+  static constexpr int BIT_COUNT = Reg::MAX_KIND * REGS_PER_KIND;
+  static constexpr int WORD_COUNT = (BIT_COUNT + 63) / 64;
+
+  static int idx_of(Register reg) {
+    u16 id = reg.reg_id();
+    int kind = id >> 8;
+    int num = id & 0xff;
+    assert(kind < Reg::MAX_KIND && num < REGS_PER_KIND);
+    return kind * REGS_PER_KIND + num;
+  }
+
+  static Register reg_from_idx(int idx) {
+    return Register(Reg::RegisterKind(idx / REGS_PER_KIND), idx % REGS_PER_KIND);
+  }
+
+  // find the first register at or after idx. BIT_COUNT if there are none.
+  int next_idx(int idx) const {
+    while (idx < BIT_COUNT) {
+      u64 word = m_bits[idx / 64] >> (idx % 64);
+      if (!word) {
+        idx = (idx / 64 + 1) * 64;
+        continue;
+      }
+      while (!(word & 1)) {
+        word >>= 1;
+        idx++;
+      }
+      return idx;
+    }
+    return BIT_COUNT;
+  }
+
+  u64 m_bits[WORD_COUNT] = {0};
+};
 
 struct RegUsageInfo {
   struct PerBlock {
@@ -29,4 +164,4 @@ struct RegUsageInfo {
 };
 
 RegUsageInfo analyze_ir2_register_usage(const Function& function);
-}  // namespace decompiler
\ No newline at end of file
+}  // namespace decompiler
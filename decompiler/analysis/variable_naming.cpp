@@ -326,8 +326,7 @@ SSA make_rc_ssa(const Function& function, const RegUsageInfo& rui, const Functio
           if (as_set->src().is_identity() && as_set->src().get_arg(0).is_var()) {
             auto src = as_set->src().get_arg(0).var().reg();
             auto dst = as_set->dst().reg();
-            if (is_arg_reg(src) && is_saved_reg(dst) &&
-                rui.op.at(op_id).consumes.find(src) != rui.op.at(op_id).consumes.end()) {
+            if (is_arg_reg(src) && is_saved_reg(dst) && rui.op.at(op_id).consumes.contains(src)) {
               ssa_i.is_arg_coloring_move = true;
             } else {
               got_not_arg_coloring = true;
@@ -4,8 +4,6 @@
  *
  * TODO -
  * support 24-bit textures
- * support 4-bit CLUT
- * support other cpsms
  * export other mips
  * check all data is read
  * export info files
@@ -14,6 +12,7 @@
  * check duplicate names
  */
 
+#include <algorithm>
 #include <common/util/FileUtil.h>
 #include "tpage.h"
 #include "common/versions.h"
@@ -283,7 +282,10 @@ u32 rgba16_to_rgba32(u32 in) {
  */
 
 // texture format names.
-std::unordered_map<u8, std::string> psms = {{0x02, "PSMCT16"}, {0x13, "PSMT8"}, {0x14, "PSMT4"}};
+std::unordered_map<u8, std::string> psms = {{0x00, "PSMCT32"},
+                                            {0x02, "PSMCT16"},
+                                            {0x13, "PSMT8"},
+                                            {0x14, "PSMT4"}};
 
 /*!
  * GOAL texture type. Stores info about a single texture in a texture page.
@@ -621,15 +623,162 @@ TexturePage read_texture_page(ObjectFileData& data,
 }
 
 // texture format enums
-enum class PSM { PSMCT16 = 0x02, PSMT8 = 0x13, PSMT4 = 0x14 };
+enum class PSM { PSMCT32 = 0x00, PSMCT16 = 0x02, PSMT8 = 0x13, PSMT4 = 0x14 };
 // clut format enums
 enum class CPSM { PSMCT32 = 0x0, PSMCT16 = 0x02 };
 
+/*!
+ * The address of each pixel in a single GS block, relative to the address of the block.
+ * Pixels in the same block only differ by this offset, so the full address function only needs to
+ * be evaluated once per block, and the pixels in the block are found with a table lookup.
+ */
+template <int W, int H>
+struct BlockSwizzle {
+  static constexpr int width = W;
+  static constexpr int height = H;
+  u32 offsets[H][W];
+
+  template <typename AddrFunc>
+  explicit BlockSwizzle(AddrFunc addr) {
+    for (int y = 0; y < H; y++) {
+      for (int x = 0; x < W; x++) {
+        offsets[y][x] = addr(x, y, 128);
+      }
+    }
+  }
+};
+
+// block sizes are from Ch. 8, Details of GS Local Memory.
+const BlockSwizzle<8, 8> psmct32_block(psmct32_addr);
+const BlockSwizzle<16, 8> psmct16_block(psmct16_addr);
+const BlockSwizzle<16, 16> psmt8_block(psmt8_addr);
+const BlockSwizzle<32, 16> psmt4_block(psmt4_addr_half_byte);
+
+/*!
+ * Call f(x, y, addr) for each pixel in a w x h rectangle, where addr is the address of the pixel
+ * from addr_func, plus base. Pixels are visited one block at a time.
+ */
+template <typename Swizzle, typename AddrFunc, typename PixelFunc>
+void for_each_pixel_by_block(const Swizzle& swizzle,
+                             AddrFunc addr_func,
+                             int w,
+                             int h,
+                             u32 buffer_width,
+                             u32 base,
+                             PixelFunc f) {
+  for (int block_y = 0; block_y < h; block_y += Swizzle::height) {
+    int y_end = std::min(int(Swizzle::height), h - block_y);
+    for (int block_x = 0; block_x < w; block_x += Swizzle::width) {
+      int x_end = std::min(int(Swizzle::width), w - block_x);
+      u32 block_addr = addr_func(block_x, block_y, buffer_width) + base;
+      for (int y = 0; y < y_end; y++) {
+        for (int x = 0; x < x_end; x++) {
+          f(block_x + x, block_y + y, block_addr + swizzle.offsets[y][x]);
+        }
+      }
+    }
+  }
+}
+
+/*!
+ * Read a CLUT from VRAM. The palette index turns into an X, Y value in the CLUT.
+ * See GS manual 2.7.3 CLUT Storage Mode, IDTEX8 and IDTEX4 in CSM1 mode.
+ * The result is indexed by palette index and is in RGBA8888.
+ */
+std::vector<u32> read_clut(const u8* vram, const Texture& tex, int entry_count) {
+  std::vector<u32> result(entry_count);
+  for (int value = 0; value < entry_count; value++) {
+    u8 clx = 0, cly = 0;
+    if (entry_count == 256) {
+      u32 clut_chunk = value / 16;
+      u32 off_in_chunk = value % 16;
+      if (clut_chunk & 1) {
+        clx = 8;
+      }
+      cly = (clut_chunk >> 1) * 2;
+      if (off_in_chunk >= 8) {
+        off_in_chunk -= 8;
+        cly++;
+      }
+      clx += off_in_chunk;
+    } else {
+      assert(entry_count == 16);
+      clx = value & 0x7;
+      cly = value >> 3;
+    }
+
+    if (tex.clutpsm == int(CPSM::PSMCT32)) {
+      u32 clut_addr = psmct32_addr(clx, cly, 64) + tex.clutdest * 256;
+      result[value] = *(const u32*)(vram + clut_addr);
+    } else {
+      assert(tex.clutpsm == int(CPSM::PSMCT16));
+      u32 clut_addr = psmct16_addr(clx, cly, 64) + tex.clutdest * 256;
+      result[value] = rgba16_to_rgba32(*(const u16*)(vram + clut_addr));
+    }
+  }
+  return result;
+}
+
+/*!
+ * Read a texture out of VRAM and convert it to RGBA8888.
+ * Returns false if the texture format isn't supported.
+ */
+bool read_texture_from_vram(const u8* vram, const Texture& tex, std::vector<u32>& out) {
+  out.resize(tex.w * tex.h);
+  // width is like the TEX0 register, in 64 texel units.
+  // not sure what the other widths are yet.
+  u32 read_width = 64 * tex.width[0];
+  bool clut32 = tex.clutpsm == int(CPSM::PSMCT32);
+  bool clut16 = tex.clutpsm == int(CPSM::PSMCT16);
+
+  if (tex.psm == int(PSM::PSMT8) && (clut32 || clut16)) {
+    auto clut = read_clut(vram, tex, 256);
+    // read as the PSMT8 type. The dest field tells us a block offset.
+    for_each_pixel_by_block(psmt8_block, psmt8_addr, tex.w, tex.h, read_width, tex.dest[0] * 256,
+                            [&](int x, int y, u32 addr8) { out[x + y * tex.w] = clut[vram[addr8]]; });
+    return true;
+  }
+
+  if (tex.psm == int(PSM::PSMT4) && (clut32 || clut16)) {
+    auto clut = read_clut(vram, tex, 16);
+    // read as the PSMT4 type, use half byte addressing
+    for_each_pixel_by_block(psmt4_block, psmt4_addr_half_byte, tex.w, tex.h, read_width,
+                            tex.dest[0] * 512, [&](int x, int y, u32 addr4) {
+                              u8 value = vram[addr4 / 2];
+                              value = (addr4 & 1) ? (value >> 4) : (value & 0x0f);
+                              out[x + y * tex.w] = clut[value];
+                            });
+    return true;
+  }
+
+  if (tex.psm == int(PSM::PSMCT16) && tex.clutpsm == 0) {
+    // not a clut.
+    for_each_pixel_by_block(psmct16_block, psmct16_addr, tex.w, tex.h, read_width,
+                            tex.dest[0] * 256, [&](int x, int y, u32 addr16) {
+                              out[x + y * tex.w] = rgba16_to_rgba32(*(const u16*)(vram + addr16));
+                            });
+    return true;
+  }
+
+  if (tex.psm == int(PSM::PSMCT32) && tex.clutpsm == 0) {
+    // not a clut.
+    for_each_pixel_by_block(psmct32_block, psmct32_addr, tex.w, tex.h, read_width,
+                            tex.dest[0] * 256, [&](int x, int y, u32 addr32) {
+                              out[x + y * tex.w] = *(const u32*)(vram + addr32);
+                            });
+    return true;
+  }
+
+  return false;
+}
+
 }  // namespace
 
 /*!
  * Process a texture page.
- * TODO - document
+ * The texture data is copied into a fake VRAM, then each texture is read back out of VRAM in its
+ * own format and written to a PNG.
+ * This is safe to call on different tpages from multiple threads at the same time.
  */
 TPageResultStats process_tpage(ObjectFileData& data) {
   TPageResultStats stats;
@@ -662,8 +811,9 @@ TPageResultStats process_tpage(ObjectFileData& data) {
   }
 
   // "VRAM", will be used as temporary storage for scrambled up textures.
-  std::vector<u8> vram;
-  vram.resize(4 * 1024 * 1024);  // 4 MB, like PS2 VRAM
+  // Each thread reuses its own, instead of allocating a new one per tpage.
+  thread_local std::vector<u8> vram;
+  vram.assign(4 * 1024 * 1024, 0);  // 4 MB, like PS2 VRAM
 
   // all textures are copied to vram 128 pixels wide, regardless of actual width
   int copy_width = 128;
@@ -671,15 +821,13 @@ TPageResultStats process_tpage(ObjectFileData& data) {
   int copy_height = tex_size / copy_width;
 
   // copy texture to "VRAM" in PSMCT32 format, regardless of actual texture format.
-  for (int y = 0; y < copy_height; y++) {
-    for (int x = 0; x < copy_width; x++) {
-      // VRAM address (bytes)
-      auto addr32 = psmct32_addr(x, y, copy_width);
-      *(u32*)(vram.data() + addr32) = *(u32*)(tex_data.data() + (x + y * copy_width));
-    }
-  }
+  for_each_pixel_by_block(psmct32_block, psmct32_addr, copy_width, copy_height, copy_width, 0,
+                          [&](int x, int y, u32 addr32) {
+                            *(u32*)(vram.data() + addr32) = tex_data[x + y * copy_width];
+                          });
 
   // get all textures in the tpage
+  std::vector<u32> out;
   for (auto& tex : texture_page.textures) {
     // I think these get inserted for CLUTs, but I'm not sure.
     if (tex.null_texture) {
@@ -688,222 +836,22 @@ TPageResultStats process_tpage(ObjectFileData& data) {
 
     stats.total_textures++;
 
-    if (tex.psm == int(PSM::PSMT8) && tex.clutpsm == int(CPSM::PSMCT32)) {
-      // this is the only supported texture format for now.
-
-      // will store output pixels, rgba (8888)
-      std::vector<u32> out;
-
-      // width is like the TEX0 register, in 64 texel units.
-      // not sure what the other widths are yet.
-      int read_width = 64 * tex.width[0];
-
-      // loop over pixels in output texture image
-      for (int y = 0; y < tex.h; y++) {
-        for (int x = 0; x < tex.w; x++) {
-          // read as the PSMT8 type. The dest field tells us a block offset.
-          auto addr8 = psmt8_addr(x, y, read_width) + tex.dest[0] * 256;
-          u8 value = *(u8*)(vram.data() + addr8);
-
-          // there's yet another scramble from the CLUT. The palette index turns into an X, Y value
-          // See GS manual 2.7.3 CLUT Storage Mode, IDTEX8 in CSM1 mode.
-          u32 clut_chunk = value / 16;
-          u32 off_in_chunk = value % 16;
-          u8 clx = 0, cly = 0;
-          if (clut_chunk & 1) {
-            clx = 8;
-          }
-          cly = (clut_chunk >> 1) * 2;
-          if (off_in_chunk >= 8) {
-            off_in_chunk -= 8;
-            cly++;
-          }
-          clx += off_in_chunk;
-
-          // the x, y CLUT value is looked up in PSMCT32 mode
-          u32 clut_addr = psmct32_addr(clx, cly, 64) + tex.clutdest * 256;
-          u32 clut_value = *(u32*)(vram.data() + clut_addr);
-          out.push_back(clut_value);
-        }
-      }
-
-      // write texture to a PNG.
-      file_util::create_dir_if_needed(
-          file_util::get_file_path({"assets", "textures", texture_page.name}));
-      file_util::write_rgba_png(
-          fmt::format(file_util::get_file_path(
-                          {"assets", "textures", texture_page.name, "{}-{}-{}-{}.png"}),
-                      data.name_in_dgo, tex.name, tex.w, tex.h),
-          out.data(), tex.w, tex.h);
-      stats.successful_textures++;
-    } else if (tex.psm == int(PSM::PSMT8) && tex.clutpsm == int(CPSM::PSMCT16)) {
-      // will store output pixels, rgba (8888)
-      std::vector<u32> out;
-
-      // width is like the TEX0 register, in 64 texel units.
-      // not sure what the other widths are yet.
-      int read_width = 64 * tex.width[0];
-
-      // loop over pixels in output texture image
-      for (int y = 0; y < tex.h; y++) {
-        for (int x = 0; x < tex.w; x++) {
-          // read as the PSMT8 type. The dest field tells us a block offset.
-          auto addr8 = psmt8_addr(x, y, read_width) + tex.dest[0] * 256;
-          u8 value = *(u8*)(vram.data() + addr8);
-
-          // there's yet another scramble from the CLUT. The palette index turns into an X, Y value
-          // See GS manual 2.7.3 CLUT Storage Mode, IDTEX8 in CSM1 mode.
-          u32 clut_chunk = value / 16;
-          u32 off_in_chunk = value % 16;
-          u8 clx = 0, cly = 0;
-          if (clut_chunk & 1) {
-            clx = 8;
-          }
-          cly = (clut_chunk >> 1) * 2;
-          if (off_in_chunk >= 8) {
-            off_in_chunk -= 8;
-            cly++;
-          }
-          clx += off_in_chunk;
-
-          // the x, y CLUT value is looked up in PSMCT32 mode
-          u32 clut_addr = psmct16_addr(clx, cly, 64) + tex.clutdest * 256;
-          u32 clut_value = *(u16*)(vram.data() + clut_addr);
-          out.push_back(rgba16_to_rgba32(clut_value));
-        }
-      }
-
-      // write texture to a PNG.
-      file_util::create_dir_if_needed(
-          file_util::get_file_path({"assets", "textures", texture_page.name}));
-      file_util::write_rgba_png(
-          fmt::format(file_util::get_file_path(
-                          {"assets", "textures", texture_page.name, "{}-{}-{}-{}.png"}),
-                      data.name_in_dgo, tex.name, tex.w, tex.h),
-          out.data(), tex.w, tex.h);
-      stats.successful_textures++;
-    } else if (tex.psm == int(PSM::PSMCT16) && tex.clutpsm == 0) {
-      // not a clut.
-      // will store output pixels, rgba (8888)
-      std::vector<u32> out;
-
-      // width is like the TEX0 register, in 64 texel units.
-      // not sure what the other widths are yet.
-      int read_width = 64 * tex.width[0];
-
-      // loop over pixels in output texture image
-      for (int y = 0; y < tex.h; y++) {
-        for (int x = 0; x < tex.w; x++) {
-          // read as the PSMT8 type. The dest field tells us a block offset.
-          auto addr8 = psmct16_addr(x, y, read_width) + tex.dest[0] * 256;
-          u16 value = *(u16*)(vram.data() + addr8);
-          out.push_back(rgba16_to_rgba32(value));
-        }
-      }
-
-      // write texture to a PNG.
-      file_util::create_dir_if_needed(
-          file_util::get_file_path({"assets", "textures", texture_page.name}));
-      file_util::write_rgba_png(
-          fmt::format(file_util::get_file_path(
-                          {"assets", "textures", texture_page.name, "{}-{}-{}-{}.png"}),
-                      data.name_in_dgo, tex.name, tex.w, tex.h),
-          out.data(), tex.w, tex.h);
-      stats.successful_textures++;
-    } else if (tex.psm == int(PSM::PSMT4) && tex.clutpsm == int(CPSM::PSMCT16)) {
-      // will store output pixels, rgba (8888)
-      std::vector<u32> out;
-
-      // width is like the TEX0 register, in 64 texel units.
-      // not sure what the other widths are yet.
-      int read_width = 64 * tex.width[0];
-
-      // loop over pixels in output texture image
-      for (int y = 0; y < tex.h; y++) {
-        for (int x = 0; x < tex.w; x++) {
-          // read as the PSMT4 type, use half byte addressing
-          auto addr4 = psmt4_addr_half_byte(x, y, read_width) + tex.dest[0] * 512;
-
-          // read (half bytes)
-          u8 value = *(u8*)(vram.data() + addr4 / 2);
-          if (addr4 & 1) {
-            value >>= 4;
-          } else {
-            value = value & 0x0f;
-          }
-
-          // there's yet another scramble from the CLUT. The palette index turns into an X, Y value
-          // See GS manual 2.7.3 CLUT Storage Mode, IDTEX4 in CSM1 mode.
-
-          u8 clx = value & 0x7;
-          u8 cly = value >> 3;
-
-          // the x, y CLUT value is looked up in PSMCT16 mode
-          u32 clut_addr = psmct16_addr(clx, cly, 64) + tex.clutdest * 256;
-          u32 clut_value = *(u16*)(vram.data() + clut_addr);
-          out.push_back(rgba16_to_rgba32(clut_value));
-        }
-      }
-
-      // write texture to a PNG.
-      file_util::create_dir_if_needed(
-          file_util::get_file_path({"assets", "textures", texture_page.name}));
-      file_util::write_rgba_png(
-          fmt::format(file_util::get_file_path(
-                          {"assets", "textures", texture_page.name, "{}-{}-{}-{}.png"}),
-                      data.name_in_dgo, tex.name, tex.w, tex.h),
-          out.data(), tex.w, tex.h);
-      stats.successful_textures++;
-    } else if (tex.psm == int(PSM::PSMT4) && tex.clutpsm == int(CPSM::PSMCT32)) {
-      // will store output pixels, rgba (8888)
-      std::vector<u32> out;
-
-      // width is like the TEX0 register, in 64 texel units.
-      // not sure what the other widths are yet.
-      int read_width = 64 * tex.width[0];
-
-      // loop over pixels in output texture image
-      for (int y = 0; y < tex.h; y++) {
-        for (int x = 0; x < tex.w; x++) {
-          // read as the PSMT4 type, use half byte addressing
-          auto addr4 = psmt4_addr_half_byte(x, y, read_width) + tex.dest[0] * 512;
-
-          // read (half bytes)
-          u8 value = *(u8*)(vram.data() + addr4 / 2);
-          if (addr4 & 1) {
-            value >>= 4;
-          } else {
-            value = value & 0x0f;
-          }
-
-          // there's yet another scramble from the CLUT. The palette index turns into an X, Y value
-          // See GS manual 2.7.3 CLUT Storage Mode, IDTEX4 in CSM1 mode.
-
-          u8 clx = value & 0x7;
-          u8 cly = value >> 3;
-
-          // the x, y CLUT value is looked up in PSMCT16 mode
-          u32 clut_addr = psmct32_addr(clx, cly, 64) + tex.clutdest * 256;
-          u32 clut_value = *(u32*)(vram.data() + clut_addr);
-          out.push_back(clut_value);
-        }
-      }
-
-      // write texture to a PNG.
-      file_util::create_dir_if_needed(
-          file_util::get_file_path({"assets", "textures", texture_page.name}));
-      file_util::write_rgba_png(
-          fmt::format(file_util::get_file_path(
-                          {"assets", "textures", texture_page.name, "{}-{}-{}-{}.png"}),
-                      data.name_in_dgo, tex.name, tex.w, tex.h),
-          out.data(), tex.w, tex.h);
-      stats.successful_textures++;
-    }
-
-    else {
+    // will store output pixels, rgba (8888)
+    if (!read_texture_from_vram(vram.data(), tex, out)) {
       printf("Unsupported texture 0x%x 0x%x\n", tex.psm, tex.clutpsm);
+      continue;
     }
+
+    // write texture to a PNG.
+    file_util::create_dir_if_needed(
+        file_util::get_file_path({"assets", "textures", texture_page.name}));
+    file_util::write_rgba_png(
+        fmt::format(
+            file_util::get_file_path({"assets", "textures", texture_page.name, "{}-{}-{}-{}.png"}),
+            data.name_in_dgo, tex.name, tex.w, tex.h),
+        out.data(), tex.w, tex.h);
+    stats.successful_textures++;
   }
   return stats;
 }
-}  // namespace decompiler
\ No newline at end of file
+}  // namespace decompiler
@@ -88,7 +88,8 @@ void DecompilerTypeSystem::parse_type_defs(const std::vector<std::string>& file_
   });
 }
 
-TypeSpec DecompilerTypeSystem::parse_type_spec(const std::string& str) {
+TypeSpec DecompilerTypeSystem::parse_type_spec(const std::string& str) const {
+  std::lock_guard<std::mutex> lock(m_reader_mutex);
   auto read = m_reader.read_from_string(str);
   auto data = cdr(read);
   return parse_typespec(&ts, car(data));
@@ -287,23 +288,23 @@ TP_Type DecompilerTypeSystem::tp_lca(const TP_Type& existing,
 /*!
  * Find the least common ancestor of an entire typestate.
  */
-bool DecompilerTypeSystem::tp_lca(TypeState* combined, const TypeState& add) {
+bool DecompilerTypeSystem::tp_lca(TypeState* combined, const TypeState& add) const {
   bool result = false;
-  for (int i = 0; i < 32; i++) {
-    bool diff = false;
-    auto new_type = tp_lca(combined->gpr_types[i], add.gpr_types[i], &diff);
-    if (diff) {
-      result = true;
-      combined->gpr_types[i] = new_type;
+  for (int i = 0; i < TypeState::SLOT_COUNT; i++) {
+    if (combined->shares_slot(i, add)) {
+      // same type object, nothing to do.
+      continue;
     }
-  }
 
-  for (int i = 0; i < 32; i++) {
     bool diff = false;
-    auto new_type = tp_lca(combined->fpr_types[i], add.fpr_types[i], &diff);
+    auto new_type = tp_lca(combined->get_slot(i), add.get_slot(i), &diff);
     if (diff) {
       result = true;
-      combined->fpr_types[i] = new_type;
+      if (new_type == add.get_slot(i)) {
+        combined->share_slot(i, add);
+      } else {
+        combined->get_slot_for_write(i) = new_type;
+      }
     }
   }
 
@@ -1,6 +1,7 @@
 #ifndef JAK_DECOMPILERTYPESYSTEM_H
 #define JAK_DECOMPILERTYPESYSTEM_H
 
+#include <mutex>
 #include "common/type_system/TypeSystem.h"
 #include "decompiler/Disasm/Register.h"
 #include "common/goos/Reader.h"
@@ -32,28 +33,21 @@ class DecompilerTypeSystem {
 
   void add_symbol(const std::string& name, const TypeSpec& type_spec);
   void parse_type_defs(const std::vector<std::string>& file_path);
-  TypeSpec parse_type_spec(const std::string& str);
+  TypeSpec parse_type_spec(const std::string& str) const;
   void add_type_flags(const std::string& name, u64 flags);
   void add_type_parent(const std::string& child, const std::string& parent);
   std::string dump_symbol_types();
   std::string lookup_parent_from_inspects(const std::string& child) const;
   bool lookup_flags(const std::string& type, u64* dest) const;
   TP_Type tp_lca(const TP_Type& existing, const TP_Type& add, bool* changed) const;
-  bool tp_lca(TypeState* combined, const TypeState& add);
+  bool tp_lca(TypeState* combined, const TypeState& add) const;
   int get_format_arg_count(const std::string& str) const;
   int get_format_arg_count(const TP_Type& type) const;
-  struct {
-    bool locked = false;
-    bool allow_pair;
-    std::string current_method_type;
-    void reset() {
-      allow_pair = false;
-      current_method_type.clear();
-    }
-  } type_prop_settings;
 
  private:
-  goos::Reader m_reader;
+  // the reader interns symbols, so it is locked to allow parse_type_spec from multiple threads.
+  mutable goos::Reader m_reader;
+  mutable std::mutex m_reader_mutex;
 };
 }  // namespace decompiler
 
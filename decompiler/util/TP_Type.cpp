@@ -12,13 +12,18 @@ u32 regs_to_gpr_mask(const std::vector<Register>& regs) {
   return result;
 }
 
+const TP_Type& TypeState::uninitialized_type() {
+  static const TP_Type uninitialized;
+  return uninitialized;
+}
+
 std::string TypeState::print_gpr_masked(u32 mask) const {
   std::string result;
   for (int i = 0; i < 32; i++) {
     if (mask & (1 << i)) {
       result += Register(Reg::GPR, i).to_charp();
       result += ": ";
-      result += gpr_types[i].print();
+      result += get_slot(i).print();
       result += " ";
     }
   }
@@ -1,4 +1,5 @@
 #pragma once
+#include <memory>
 #include <string>
 #include <cassert>
 #include "common/log/log.h"
@@ -169,33 +170,65 @@ class TP_Type {
   int64_t m_int = 0;
 };
 
+/*!
+ * The types of all GPRs and FPRs at a point in the program.
+ * Each register's type is held by a shared pointer, so copying a TypeState is cheap and registers
+ * which don't change are shared between the states of consecutive ops. A register's type is only
+ * copied when it is modified through the non-const get(). A null entry is an uninitialized type.
+ */
 struct TypeState {
-  TP_Type gpr_types[32];
-  TP_Type fpr_types[32];
+  static constexpr int SLOT_COUNT = 64;  // 32 GPRs, then 32 FPRs.
 
   std::string print_gpr_masked(u32 mask) const;
-  TP_Type& get(const Register& r) {
-    switch (r.get_kind()) {
-      case Reg::GPR:
-        return gpr_types[r.get_gpr()];
-      case Reg::FPR:
-        return fpr_types[r.get_fpr()];
-      default:
-        assert(false);
+
+  TP_Type& get(const Register& r) { return get_slot_for_write(slot_idx(r)); }
+  const TP_Type& get(const Register& r) const { return get_slot(slot_idx(r)); }
+
+  const TP_Type& get_slot(int slot) const {
+    const auto& ptr = m_types[slot];
+    return ptr ? *ptr : uninitialized_type();
+  }
+
+  TP_Type& get_slot_for_write(int slot) {
+    auto& ptr = m_types[slot];
+    if (!ptr) {
+      ptr = std::make_shared<TP_Type>();
+    } else if (ptr.use_count() > 1) {
+      ptr = std::make_shared<TP_Type>(*ptr);
     }
+    return *ptr;
+  }
+
+  /*!
+   * Do the two states use the exact same object for this register's type? If so, the types are
+   * equal and there's no need to compare them.
+   */
+  bool shares_slot(int slot, const TypeState& other) const {
+    return m_types[slot] == other.m_types[slot];
   }
 
-  const TP_Type& get(const Register& r) const {
+  /*!
+   * Make this state use the other state's type for this register.
+   */
+  void share_slot(int slot, const TypeState& other) { m_types[slot] = other.m_types[slot]; }
+
+ private:
+  static int slot_idx(const Register& r) {
     switch (r.get_kind()) {
       case Reg::GPR:
-        return gpr_types[r.get_gpr()];
+        return r.get_gpr();
       case Reg::FPR:
-        return fpr_types[r.get_fpr()];
+        return 32 + r.get_fpr();
       default:
         lg::die("Cannot use register {} with TypeState.", r.to_charp());
         assert(false);
+        return 0;
     }
   }
+
+  static const TP_Type& uninitialized_type();
+
+  std::shared_ptr<TP_Type> m_types[SLOT_COUNT];
 };
 
 u32 regs_to_gpr_mask(const std::vector<Register>& regs);
@@ -356,6 +356,8 @@ void load_and_link_dgo_from_c(const char* name, Ptr<kheapinfo> heap, u32 linkFla
     // heap available, which is important when we need to use the entire memory.
     if (lastObjectLoaded) {
       heap->top = oldHeapTop;
+      // it was written to free memory, so kmalloc can't assume that memory is still zero.
+      kmalloc_forget_zero_range(heap);
     }
 
     // determine the size and name of the object we got
@@ -820,6 +820,10 @@ Ptr<uint8_t> link_and_exec(Ptr<uint8_t> data,
                            int32_t size,
                            Ptr<kheapinfo> heap,
                            uint32_t flags) {
+  if (data.offset >= heap->current.offset && data.offset < heap->top.offset) {
+    // the object is in free memory of the heap, which kmalloc can't assume is zero anymore.
+    kmalloc_forget_zero_range(heap);
+  }
   link_control lc;
   lc.begin(data, name, size, heap, flags);
   uint32_t done;
@@ -24,6 +24,7 @@
 #include "game/sce/sif_ee.h"
 #include "game/sce/libcdvd_ee.h"
 #include "game/sce/stubs.h"
+#include "game/system/sampling_profiler.h"
 #include "common/symbols.h"
 #include "common/log/log.h"
 using namespace ee;
@@ -132,6 +133,12 @@ void InitParms(int argc, const char* const* argv) {
       DebugSegment = 0;
     }
 
+    // an added mode to record kmalloc allocations from boot, see kmalloc_profile_record
+    if (arg == "-kmalloc-profile") {
+      Msg(6, "dkernel: kmalloc profile mode\n");
+      kmalloc_profile_enabled = true;
+    }
+
     // the "-level [level-name]" mode is used to inform the game to boot a specific level
     // the default level is "#f".
     if (arg == "-level") {
@@ -553,6 +560,24 @@ void PutDisplayEnv() {
   assert(false);
 }
 
+/*!
+ * Start sampling where the EE thread is running, hz times per second (or the default rate, if 0).
+ * The compiler reads the samples with (:prof). Returns #t if the profiler started.
+ * Added.
+ */
+u64 ProfilerStart(u32 hz) {
+  return s7.offset + (sampling_profiler_start(hz) ? FIX_SYM_TRUE : FIX_SYM_FALSE);
+}
+
+/*!
+ * Stop the sampling profiler. The samples are kept until it is started again.
+ * Added.
+ */
+u64 ProfilerStop() {
+  sampling_profiler_stop();
+  return 0;
+}
+
 /*!
  * Final initialization of the system after the kernel is loaded.
  * This is called from InitHeapAndSymbol at the very end.
@@ -591,6 +616,11 @@ void InitMachineScheme() {
   make_function_symbol_from_c("dma-to-iop", (void*)dma_to_iop);                           // unused
   make_function_symbol_from_c("kernel-shutdown", (void*)KernelShutdown);                  // used
   make_function_symbol_from_c("aybabtu", (void*)sceCdMmode);                              // used
+  make_function_symbol_from_c("kmalloc-profile-enable", (void*)kmalloc_profile_enable);   // added
+  make_function_symbol_from_c("kmalloc-profile-reset", (void*)kmalloc_profile_reset);     // added
+  make_function_symbol_from_c("kmalloc-profile-print", (void*)kmalloc_profile_print);     // added
+  make_function_symbol_from_c("profiler-start", (void*)ProfilerStart);                    // added
+  make_function_symbol_from_c("profiler-stop", (void*)ProfilerStop);                      // added
   InitSoundScheme();
   intern_from_c("*stack-top*")->value = 0x07ffc000;
   intern_from_c("*stack-base*")->value = 0x07ffffff;
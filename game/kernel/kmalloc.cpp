@@ -5,21 +5,263 @@
  * DONE
  */
 
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+#include <algorithm>
 #include <cstring>
 #include <cstdio>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
 #include "common/goal_constants.h"
+#include "common/symbols.h"
 #include "kmalloc.h"
 #include "kprint.h"
 #include "kscheme.h"
+#include "kboot.h"
 
 // global and debug kernel heaps
 Ptr<kheapinfo> kglobalheap;
 Ptr<kheapinfo> kdebugheap;
 
+// when set, kmalloc records every allocation by heap and name.
+bool kmalloc_profile_enabled;
+
+namespace {
+/*!
+ * Totals for allocations with the same name on a heap. Index 0 is bottom, 1 is top.
+ */
+struct AllocStats {
+  u64 bytes[2] = {0, 0};
+  u32 count[2] = {0, 0};
+  u32 failed = 0;
+};
+
+/*!
+ * Everything recorded for a single kheap.
+ */
+struct HeapProfile {
+  std::unordered_map<std::string, AllocStats> by_name;
+  u32 bottom_high_water = 0;  // most bytes ever used by bottom allocations
+  u32 top_high_water = 0;     // most bytes ever used by top allocations
+  u32 failed = 0;
+};
+
+// ordered by heap address, so summaries always come out the same way.
+std::map<u32, HeapProfile> heap_profiles;
+
+std::string heap_name(u32 heap) {
+  if (heap == kglobalheap.offset) {
+    return "global";
+  }
+  if (heap == kdebugheap.offset) {
+    return "debug";
+  }
+  char buffer[32];
+  sprintf(buffer, "#x%x", heap);
+  return buffer;
+}
+
+/*!
+ * Build a summary of a heap's profile, listing at most max_names of the biggest users.
+ */
+std::string heap_profile_summary(u32 heap_addr, const HeapProfile& profile, u32 max_names) {
+  Ptr<kheapinfo> heap(heap_addr);
+  char line[256];
+  std::string result;
+  u32 heap_size = heap->top_base - heap->base;
+  sprintf(line, "kmalloc profile for heap %s:\n", heap_name(heap_addr).c_str());
+  result += line;
+  sprintf(line, "  bottom: %d bytes used, high water %d of %d bytes\n", heap->current - heap->base,
+          profile.bottom_high_water, heap_size);
+  result += line;
+  sprintf(line, "  top:    %d bytes used, high water %d of %d bytes\n", heap->top_base - heap->top,
+          profile.top_high_water, heap_size);
+  result += line;
+  if (profile.failed) {
+    sprintf(line, "  failed allocations: %d\n", profile.failed);
+    result += line;
+  }
+
+  std::vector<std::pair<const std::string*, const AllocStats*>> sorted;
+  sorted.reserve(profile.by_name.size());
+  for (auto& kv : profile.by_name) {
+    sorted.emplace_back(&kv.first, &kv.second);
+  }
+  std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) {
+    return a.second->bytes[0] + a.second->bytes[1] > b.second->bytes[0] + b.second->bytes[1];
+  });
+
+  sprintf(line, "  %-32s %12s %8s %12s %8s %6s\n", "name", "bottom-bytes", "count", "top-bytes",
+          "count", "failed");
+  result += line;
+  for (u32 i = 0; i < sorted.size() && i < max_names; i++) {
+    auto& stats = *sorted[i].second;
+    snprintf(line, sizeof(line), "  %-32.32s %12lld %8d %12lld %8d %6d\n", sorted[i].first->c_str(),
+             (long long)stats.bytes[0], stats.count[0], (long long)stats.bytes[1], stats.count[1],
+             stats.failed);
+    result += line;
+  }
+  if (sorted.size() > max_names) {
+    sprintf(line, "  (%d more not shown)\n", int(sorted.size() - max_names));
+    result += line;
+  }
+  return result;
+}
+}  // namespace
+
+namespace {
+/*!
+ * What we know about the free memory of a heap set up by kinitheap. Memory in [zero_lo, zero_hi)
+ * hasn't been handed out since kinitheap cleared it, so KMALLOC_MEMSET doesn't need to clear it
+ * again. This saves clearing every object when loading lots of objects into a fresh heap.
+ *
+ * current and top are where kmalloc last left the heap. Other code, like the linker, may write
+ * above current and then move current up. When we see that, we can't know how much was written,
+ * so we stop trusting the zero range. Code that writes above current without moving it must call
+ * kmalloc_forget_zero_range.
+ */
+struct HeapZeroRange {
+  u32 heap = 0;
+  u32 current = 0;
+  u32 top = 0;
+  u32 zero_lo = 0;
+  u32 zero_hi = 0;
+};
+
+// only heaps from kinitheap are tracked, which are just the global and debug heaps.
+constexpr int MAX_ZERO_RANGE_HEAPS = 4;
+HeapZeroRange heap_zero_ranges[MAX_ZERO_RANGE_HEAPS];
+int heap_zero_range_count = 0;
+
+// clearing at least this much will give pages back to the OS instead of writing zeros.
+constexpr u32 RELEASE_PAGES_MIN_SIZE = 1024 * 1024;
+constexpr u64 RELEASE_PAGE_SIZE = 4096;
+
+/*!
+ * Set memory to zero. For big ranges on Linux, the pages are dropped instead, which gives back
+ * fresh zero pages the next time they are touched and doesn't need to write the whole range.
+ */
+void clear_memory(u8* mem, u32 size) {
+#ifdef __linux__
+  if (size >= RELEASE_PAGES_MIN_SIZE) {
+    u64 start = ((u64)mem + RELEASE_PAGE_SIZE - 1) & ~(RELEASE_PAGE_SIZE - 1);
+    u64 end = ((u64)mem + size) & ~(RELEASE_PAGE_SIZE - 1);
+    // shared memory needs MADV_REMOVE to drop the contents, private memory uses MADV_DONTNEED.
+    if (madvise((void*)start, end - start, MADV_REMOVE) == 0 ||
+        madvise((void*)start, end - start, MADV_DONTNEED) == 0) {
+      std::memset(mem, 0, start - (u64)mem);
+      std::memset((void*)end, 0, (u64)mem + size - end);
+      return;
+    }
+  }
+#endif
+  std::memset(mem, 0, size);
+}
+
+HeapZeroRange* find_zero_range(u32 heap) {
+  for (int i = 0; i < heap_zero_range_count; i++) {
+    if (heap_zero_ranges[i].heap == heap) {
+      return &heap_zero_ranges[i];
+    }
+  }
+  return nullptr;
+}
+
+/*!
+ * Start tracking the zero range of a heap that was just cleared.
+ */
+void track_zero_range(Ptr<kheapinfo> heap) {
+  auto range = find_zero_range(heap.offset);
+  if (!range) {
+    if (heap_zero_range_count == MAX_ZERO_RANGE_HEAPS) {
+      return;
+    }
+    range = &heap_zero_ranges[heap_zero_range_count++];
+  }
+  range->heap = heap.offset;
+  range->current = heap->current.offset;
+  range->top = heap->top.offset;
+  range->zero_lo = heap->base.offset;
+  range->zero_hi = heap->top_base.offset;
+}
+
+/*!
+ * Update the zero range for changes to the heap made outside of kmalloc.
+ */
+void check_zero_range(HeapZeroRange* range, Ptr<kheapinfo> heap) {
+  if (heap->current.offset > range->current) {
+    // somebody else allocated, and may have written past where they allocated.
+    range->zero_hi = range->zero_lo;
+  }
+  range->zero_hi = std::min(range->zero_hi, heap->top.offset);
+}
+
+/*!
+ * Clear the parts of a new allocation that might not be zero, and remove it from the zero range.
+ */
+void clear_allocation(HeapZeroRange* range, u32 start, u32 end, bool top, bool clear) {
+  if (!range) {
+    if (clear) {
+      std::memset(Ptr<u8>(start).c(), 0, end - start);
+    }
+    return;
+  }
+
+  if (clear) {
+    if (range->zero_lo >= range->zero_hi) {
+      std::memset(Ptr<u8>(start).c(), 0, end - start);
+    } else {
+      if (start < range->zero_lo) {
+        std::memset(Ptr<u8>(start).c(), 0, std::min(end, range->zero_lo) - start);
+      }
+      if (end > range->zero_hi) {
+        u32 dirty_start = std::max(start, range->zero_hi);
+        std::memset(Ptr<u8>(dirty_start).c(), 0, end - dirty_start);
+      }
+    }
+  }
+
+  if (top) {
+    range->zero_hi = std::min(range->zero_hi, start);
+  } else {
+    range->zero_lo = std::max(range->zero_lo, end);
+  }
+}
+
+/*!
+ * Remember where kmalloc left the heap, to detect changes made by others.
+ */
+void update_zero_range(HeapZeroRange* range, Ptr<kheapinfo> heap) {
+  if (range) {
+    range->current = heap->current.offset;
+    range->top = heap->top.offset;
+  }
+}
+}  // namespace
+
+/*!
+ * Stop assuming any free memory of this heap is zero. Must be called by code that writes to the
+ * free memory of a heap without allocating it first, like loading an object at heap->current.
+ * Not in the original game.
+ */
+void kmalloc_forget_zero_range(Ptr<kheapinfo> heap) {
+  auto range = find_zero_range(heap.offset);
+  if (range) {
+    range->zero_hi = range->zero_lo;
+  }
+}
+
 void kmalloc_init_globals() {
   // _globalheap and _debugheap
   kglobalheap.offset = GLOBAL_HEAP_INFO_ADDR;
   kdebugheap.offset = DEBUG_HEAP_INFO_ADDR;
+  kmalloc_profile_enabled = false;
+  heap_profiles.clear();
+  heap_zero_range_count = 0;
 }
 
 /*!
@@ -80,14 +322,16 @@ void kheapstatus(Ptr<kheapinfo> heap) {
 
 /*!
  * Initialize a kheapinfo structure, and clear the kheap's memory to 0.
- * DONE, EXACT
+ * DONE
+ * Modified to remember that the heap is clear, so kmalloc doesn't clear it again.
  */
 Ptr<kheapinfo> kinitheap(Ptr<kheapinfo> heap, Ptr<u8> mem, s32 size) {
   heap->base = mem;
   heap->current = mem;
   heap->top = mem + size;
   heap->top_base = heap->top;
-  std::memset(mem.c(), 0, size);
+  clear_memory(mem.c(), size);
+  track_zero_range(heap);
   return heap;
 }
 
@@ -107,6 +351,7 @@ u32 kheapused(Ptr<kheapinfo> heap) {
  * @param name    : name of allocation (printed if things go wrong)
  * @return        : memory.  0 if we run out of room
  * DONE, PRINT ADDED
+ * Modified to skip clearing memory which is known to be zero already.
  */
 Ptr<u8> kmalloc(Ptr<kheapinfo> heap, s32 size, u32 flags, char const* name) {
   uint32_t alignment_flag = flags & 0xfff;
@@ -118,6 +363,11 @@ Ptr<u8> kmalloc(Ptr<kheapinfo> heap, s32 size, u32 flags, char const* name) {
     heap = kglobalheap;
   }
 
+  auto zero_range = find_zero_range(heap.offset);
+  if (zero_range) {
+    check_zero_range(zero_range, heap);
+  }
+
   uint32_t memstart;
 
   if (!(flags & KMALLOC_TOP)) {
@@ -139,12 +389,18 @@ Ptr<u8> kmalloc(Ptr<kheapinfo> heap, s32 size, u32 flags, char const* name) {
     if (heap->top.offset < memend) {
       kheapstatus(heap);
       Msg(6, "kmalloc: !alloc mem %s (%d bytes) heap %x\n", name, size, heap.offset);
+      if (kmalloc_profile_enabled) {
+        kmalloc_profile_record(heap, size, flags, name, false);
+      }
       return Ptr<u8>(0);
     }
 
     heap->current.offset = memend;
-    if (flags & KMALLOC_MEMSET)
-      std::memset(Ptr<u8>(memstart).c(), 0, (size_t)size);
+    if (kmalloc_profile_enabled) {
+      kmalloc_profile_record(heap, size, flags, name, true);
+    }
+    clear_allocation(zero_range, memstart, memend, false, flags & KMALLOC_MEMSET);
+    update_zero_range(zero_range, heap);
     return Ptr<u8>(memstart);
   } else {
     // allocate from top
@@ -162,13 +418,19 @@ Ptr<u8> kmalloc(Ptr<kheapinfo> heap, s32 size, u32 flags, char const* name) {
     if (heap->current.offset >= memstart) {
       Msg(6, "kmalloc: !alloc mem from top %s (%d bytes) heap %x\n", name, size, heap.offset);
       kheapstatus(heap);
+      if (kmalloc_profile_enabled) {
+        kmalloc_profile_record(heap, size, flags, name, false);
+      }
       return Ptr<u8>(0);
     }
 
     heap->top.offset = memstart;
+    if (kmalloc_profile_enabled) {
+      kmalloc_profile_record(heap, size, flags, name, true);
+    }
 
-    if (flags & 0x1000)
-      std::memset(Ptr<u8>(memstart).c(), 0, (size_t)size);
+    clear_allocation(zero_range, memstart, memstart + size, true, flags & KMALLOC_MEMSET);
+    update_zero_range(zero_range, heap);
     return Ptr<u8>(memstart);
   }
 }
@@ -182,3 +444,60 @@ void kfree(Ptr<u8> a) {
   (void)a;
   Msg(6, "[ERROR] kmalloc: kfree called\n");
 }
+
+/*!
+ * Record an allocation for the profile. Only called by kmalloc when kmalloc_profile_enabled is set.
+ * If the allocation failed, the profile of the heap is printed, to show what filled it up.
+ * Not in the original game.
+ */
+void kmalloc_profile_record(Ptr<kheapinfo> heap, s32 size, u32 flags, char const* name, bool ok) {
+  auto& profile = heap_profiles[heap.offset];
+  auto& stats = profile.by_name[name ? name : "(null)"];
+  int side = (flags & KMALLOC_TOP) ? 1 : 0;
+  if (!ok) {
+    stats.failed++;
+    profile.failed++;
+    Msg(6, "%s", heap_profile_summary(heap.offset, profile, 32).c_str());
+    return;
+  }
+
+  stats.bytes[side] += size;
+  stats.count[side]++;
+  profile.bottom_high_water = std::max(profile.bottom_high_water, u32(heap->current - heap->base));
+  profile.top_high_water = std::max(profile.top_high_water, u32(heap->top_base - heap->top));
+}
+
+/*!
+ * Turn allocation profiling on or off. Takes a GOAL boolean.
+ * Exported to GOAL as kmalloc-profile-enable. Not in the original game.
+ */
+u64 kmalloc_profile_enable(u32 enable) {
+  kmalloc_profile_enabled = enable != s7.offset + FIX_SYM_FALSE;
+  return 0;
+}
+
+/*!
+ * Forget everything recorded so far.
+ * Exported to GOAL as kmalloc-profile-reset. Not in the original game.
+ */
+u64 kmalloc_profile_reset() {
+  heap_profiles.clear();
+  return 0;
+}
+
+/*!
+ * Print the profile of each heap, with at most max_names names per heap.
+ * If we're connected to the compiler, this goes to the listener. Otherwise it goes to stdout.
+ * Exported to GOAL as kmalloc-profile-print. Not in the original game.
+ */
+u64 kmalloc_profile_print(u32 max_names) {
+  for (auto& kv : heap_profiles) {
+    auto summary = heap_profile_summary(kv.first, kv.second, max_names);
+    if (MasterDebug) {
+      cprintf("%s", summary.c_str());
+    } else {
+      Msg(6, "%s", summary.c_str());
+    }
+  }
+  return 0;
+}
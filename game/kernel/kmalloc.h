@@ -43,6 +43,14 @@ u32 kheapused(Ptr<kheapinfo> heap);
 Ptr<u8> kmalloc(Ptr<kheapinfo> heap, s32 size, u32 flags, char const* name);
 void kfree(Ptr<u8> a);
 
+// allocation profiling (not in the original game)
+extern bool kmalloc_profile_enabled;
+void kmalloc_profile_record(Ptr<kheapinfo> heap, s32 size, u32 flags, char const* name, bool ok);
+u64 kmalloc_profile_enable(u32 enable);
+u64 kmalloc_profile_reset();
+u64 kmalloc_profile_print(u32 max_names);
+
+void kmalloc_forget_zero_range(Ptr<kheapinfo> heap);
 void kmalloc_init_globals();
 
 #endif  // JAK_KMALLOC_H
@@ -5,6 +5,10 @@
 
 #include <cstring>
 #include <cassert>
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 #include "kscheme.h"
 #include "common/common_types.h"
 #include "common/goal_constants.h"
@@ -39,8 +43,8 @@ Ptr<u32> LastSymbol;
 s32 NumSymbols;
 
 // set to true to enable propagating method overrides to child types
-// this is an O(N_max_symbols) operation, so it is avoided when loading DGOs for levels.
-// but is enabled when loading the engine.
+// in the original kernel this was an O(N_max_symbols) operation, so it is avoided when loading DGOs
+// for levels. but is enabled when loading the engine.
 Ptr<u32> EnableMethodSet;
 
 // used for crc32 calculation
@@ -49,6 +53,10 @@ u32 crc_table[0x100];
 // value of the GOAL s7 register, pointing to the middle of the symbol table
 Ptr<u32> s7;
 
+// the children of each type, so method_set can find the types inheriting a method without scanning
+// the symbol table. This isn't in GOAL memory, and is kept up to date by set_type_values.
+std::unordered_map<u32, std::vector<u32>> TypeChildren;
+
 void kscheme_init_globals() {
   for (auto& x : crc_table) {
     x = 0;
@@ -59,6 +67,7 @@ void kscheme_init_globals() {
   LastSymbol.offset = 0;
   EnableMethodSet.offset = 0;
   FastLink = 0;
+  TypeChildren.clear();
 }
 
 /*!
@@ -910,6 +919,18 @@ u64 new_type(u32 symbol, u32 parent, u64 flags) {
  * Configure a type.
  */
 Ptr<Type> set_type_values(Ptr<Type> type, Ptr<Type> parent, u64 flags) {
+  // move the type to its new parent in the hierarchy index. A new type's parent field may be
+  // garbage, but then it won't be found in the index either.
+  auto& children = TypeChildren[parent.offset];
+  if (std::find(children.begin(), children.end(), type.offset) == children.end()) {
+    auto old = TypeChildren.find(type->parent.offset);
+    if (old != TypeChildren.end()) {
+      old->second.erase(std::remove(old->second.begin(), old->second.end(), type.offset),
+                        old->second.end());
+    }
+    children.push_back(type.offset);
+  }
+
   type->parent = parent;
   type->allocated_size = (flags & 0xffff);
   type->heap_base = (flags >> 16) & 0xffff;
@@ -942,8 +963,8 @@ u64 type_typep(Ptr<Type> t1, Ptr<Type> t2) {
 
 /*!
  * Set method of type.
- * Looks at the EnableMethodSet symbol to determine if it should loop through all types looking for
- * children and updating those.  Only updates children who haven't overridden the method previously.
+ * Looks at the EnableMethodSet symbol to determine if it should loop through all children of the
+ * type and update those.  Only updates children who haven't overridden the method previously.
  *
  * Even if EnableMethodSet is disabled, it will still do this loop if FastLink is disabled,
  * MasterDebug is enabled, or DiskBoot is false.  This is likely for debugging reasons?
@@ -980,87 +1001,44 @@ u64 method_set(u32 type_, u32 method_id, u32 method) {
 
   // this is kind of a strange combination...
   if (*EnableMethodSet || (!FastLink && MasterDebug && !DiskBoot)) {
-    // upper table
-    auto sym = s7.offset;
-    for (; sym < LastSymbol.offset; sym += 8) {
-      auto symValue = *Ptr<u32>(sym);
-      if ((symValue < SymbolTable2.offset || 0x7ffffff < symValue) &&  // not in normal memory
-          (symValue < 0x84000 || 0x100000 <= symValue)) {              // not in kernel memory
-        continue;
-      }
-
-      if ((symValue & OFFSET_MASK) != BASIC_OFFSET) {
-        continue;
-      }
-
-      auto objType = *Ptr<Ptr<Type>>(symValue - 4);
-      if (objType.offset != *(s7 + FIX_SYM_TYPE_TYPE)) {
-        continue;
-      }
-
-      auto symAsType = Ptr<Type>(symValue);
-      if (method_id >= symAsType->num_methods) {
-        continue;
-      }
-
-      if (symAsType->get_method(method_id).offset != existing_method) {
-        continue;
-      }
-
-      if (type_typep(symAsType, type) == s7.offset) {
-        continue;
-      }
-
-      if (FastLink) {
-        // you were saved by EnableMethodSet.  I guess we warn.
-        printf("************ WARNING **************\n");
-        printf("method %d of %s redefined - you must define class heirarchies in order now\n",
-               method_id, info(symAsType->symbol)->str->data());
-        printf("***********************************\n");
-      }
-
-      symAsType->get_method(method_id).offset = method;
-    }
-
-    sym = SymbolTable2.offset;
-    for (; sym < s7.offset; sym += 8) {
-      auto symValue = *Ptr<u32>(sym);
-      if ((symValue < SymbolTable2.offset || 0x7ffffff < symValue) &&  // not in normal memory
-          (symValue < 0x84000 || 0x100000 <= symValue)) {              // not in kernel memory
+    // The original kernel scanned both halves of the symbol table for types where
+    // (type_typep child type). We only visit the descendants of type in the hierarchy index.
+    std::vector<u32> to_visit = {type.offset};
+    std::unordered_set<u32> visited = {type.offset};
+    while (!to_visit.empty()) {
+      auto parent = to_visit.back();
+      to_visit.pop_back();
+      auto it = TypeChildren.find(parent);
+      if (it == TypeChildren.end()) {
         continue;
       }
 
-      if ((symValue & OFFSET_MASK) != BASIC_OFFSET) {
-        continue;
-      }
-
-      auto objType = *Ptr<Ptr<Type>>(symValue - 4);
-      if (objType.offset != *(s7 + FIX_SYM_TYPE_TYPE)) {
-        continue;
-      }
+      for (auto child : it->second) {
+        // the object type is its own parent.
+        if (!visited.insert(child).second) {
+          continue;
+        }
+        to_visit.push_back(child);
 
-      auto symAsType = Ptr<Type>(symValue);
-      if (method_id >= symAsType->num_methods) {
-        continue;
-      }
+        auto childType = Ptr<Type>(child);
+        if (method_id >= childType->num_methods) {
+          continue;
+        }
 
-      if (symAsType->get_method(method_id).offset != existing_method) {
-        continue;
-      }
+        if (childType->get_method(method_id).offset != existing_method) {
+          continue;
+        }
 
-      if (type_typep(symAsType, type) == s7.offset) {
-        continue;
-      }
+        if (FastLink) {
+          // you were saved by EnableMethodSet.  I guess we warn.
+          printf("************ WARNING **************\n");
+          printf("method %d of %s redefined - you must define class heirarchies in order now\n",
+                 method_id, info(childType->symbol)->str->data());
+          printf("***********************************\n");
+        }
 
-      if (FastLink) {
-        // you were saved by EnableMethodSet.  I guess we warn.
-        printf("************ WARNING **************\n");
-        printf("method %d of %s redefined - you must define class heirarchies in order now\n",
-               method_id, info(symAsType->symbol)->str->data());
-        printf("***********************************\n");
+        childType->get_method(method_id).offset = method;
       }
-
-      symAsType->get_method(method_id).offset = method;
     }
   }
   return method;
@@ -1677,6 +1655,8 @@ s32 InitHeapAndSymbol() {
   // the last symbol we will ever access.
   LastSymbol = symbol_table + 0xff00;
   NumSymbols = 0;
+  // all the old types are gone.
+  TypeChildren.clear();
   // inform compiler the symbol table is reset, and where it is.
   reset_output();
 
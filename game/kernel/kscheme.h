@@ -82,6 +82,7 @@ u64 alloc_from_heap(u32 heapSymbol, u32 type, s32 size);
 Ptr<Symbol> intern_from_c(const char* name);
 Ptr<Type> intern_type_from_c(const char* name, u64 methods);
 Ptr<Type> set_type_values(Ptr<Type> type, Ptr<Type> parent, u64 flags);
+u64 method_set(u32 type_, u32 method_id, u32 method);
 u64 print_object(u32 obj);
 u64 print_pair(u32 obj);
 u64 print_binteger(u64 obj);
@@ -57,6 +57,53 @@ namespace {
 int g_argc = 0;
 char** g_argv = nullptr;
 
+#ifdef __linux__
+// memfd backing the EE memory, if we have one. It stays open so the debugger can find it.
+int g_ee_main_mem_fd = -1;
+#endif
+
+/*!
+ * Map the EE main memory at addr.
+ * If EE_MEM_SHARED is set, try to back it with a memfd that the debugger can map too.
+ * Returns (u8*)(-1) on failure, like mmap.
+ */
+u8* map_ee_main_mem(void* addr, int extra_flags) {
+#ifdef __linux__
+  if (EE_MEM_SHARED) {
+    int fd = memfd_create(EE_MAIN_MEM_SHARED_NAME, MFD_CLOEXEC);
+    if (fd >= 0 && ftruncate(fd, EE_MAIN_MEM_SIZE) == 0) {
+      auto mem = (u8*)mmap(addr, EE_MAIN_MEM_SIZE, PROT_EXEC | PROT_READ | PROT_WRITE,
+                           MAP_SHARED | extra_flags, fd, 0);
+      if (mem != (u8*)(-1)) {
+        g_ee_main_mem_fd = fd;
+        lg::debug("Main memory is shared");
+        return mem;
+      }
+    }
+    lg::debug("Failed to create shared main memory, falling back to private: {}",
+              strerror(errno));
+    if (fd >= 0) {
+      close(fd);
+    }
+  }
+#endif
+  return (u8*)mmap(addr, EE_MAIN_MEM_SIZE, PROT_EXEC | PROT_READ | PROT_WRITE,
+                   MAP_ANONYMOUS | MAP_PRIVATE | extra_flags, 0, 0);
+}
+
+/*!
+ * Unmap the EE main memory, and close the memfd backing it if there is one.
+ */
+void unmap_ee_main_mem() {
+  munmap(g_ee_main_mem, EE_MAIN_MEM_SIZE);
+#ifdef __linux__
+  if (g_ee_main_mem_fd >= 0) {
+    close(g_ee_main_mem_fd);
+    g_ee_main_mem_fd = -1;
+  }
+#endif
+}
+
 /*!
  * SystemThread function for running the DECI2 communication with the GOAL compiler.
  */
@@ -107,13 +154,9 @@ void deci2_runner(SystemThreadInterface& iface) {
 void ee_runner(SystemThreadInterface& iface) {
   // Allocate Main RAM. Must have execute enabled.
   if (EE_MEM_LOW_MAP) {
-    g_ee_main_mem =
-        (u8*)mmap((void*)0x10000000, EE_MAIN_MEM_SIZE, PROT_EXEC | PROT_READ | PROT_WRITE,
-                  MAP_ANONYMOUS | MAP_32BIT | MAP_PRIVATE | MAP_POPULATE, 0, 0);
+    g_ee_main_mem = map_ee_main_mem((void*)0x10000000, MAP_32BIT | MAP_POPULATE);
   } else {
-    g_ee_main_mem =
-        (u8*)mmap((void*)EE_MAIN_MEM_MAP, EE_MAIN_MEM_SIZE, PROT_EXEC | PROT_READ | PROT_WRITE,
-                  MAP_ANONYMOUS | MAP_PRIVATE, 0, 0);
+    g_ee_main_mem = map_ee_main_mem((void*)EE_MAIN_MEM_MAP, 0);
   }
 
   if (g_ee_main_mem == (u8*)(-1)) {
@@ -130,7 +173,8 @@ void ee_runner(SystemThreadInterface& iface) {
   iface.initialization_complete();
 
   lg::debug("[EE] Run!");
-  memset((void*)g_ee_main_mem, 0, EE_MAIN_MEM_SIZE);
+  // a fresh mapping is already zero, so there's no need to clear it. Clearing would also touch (and
+  // allocate) every page of the 128 MB, even the ones the game never uses.
 
   // prevent access to the first 1 MB of memory.
   // On the PS2 this is the kernel and can't be accessed either.
@@ -159,7 +203,7 @@ void ee_runner(SystemThreadInterface& iface) {
   //  // kill the IOP todo
   iop::LIBRARY_kill();
 
-  munmap(g_ee_main_mem, EE_MAIN_MEM_SIZE);
+  unmap_ee_main_mem();
 
   // after main returns, trigger a shutdown.
   iface.trigger_shutdown();
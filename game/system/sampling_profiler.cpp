@@ -0,0 +1,273 @@
+/*!
+ * @file sampling_profiler.cpp
+ * Periodically samples where a thread is running, for profiling GOAL code.
+ *
+ * A timer sends SIGPROF to the thread being profiled. The signal handler runs on its own stack and
+ * records rip and a copy of the top of the interrupted stack into a ProfilerBuffer, which lives in
+ * a memfd so the compiler can map it and turn the samples into a profile (see
+ * Debugger::read_profile).
+ */
+
+#ifdef __linux__
+#include <csignal>
+#include <ctime>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <ucontext.h>
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include "sampling_profiler.h"
+#include "common/goal_constants.h"
+#include "common/log/log.h"
+#include "game/runtime.h"
+
+namespace {
+ProfilerBuffer* g_buffer = nullptr;
+bool g_running = false;
+
+#ifdef __linux__
+#ifndef sigev_notify_thread_id
+#define sigev_notify_thread_id _sigev_un._tid
+#endif
+
+constexpr int PROFILER_SIGNAL = SIGPROF;
+timer_t g_timer;
+
+// the native stack of the profiled thread. GOAL processes run on stacks in EE memory instead.
+u64 g_stack_lo = 0;
+u64 g_stack_hi = 0;
+
+// the handler runs on its own stack, so the kernel's signal frame doesn't go on a small GOAL stack
+// in EE memory and overwrite whatever is below it.
+constexpr size_t SIGNAL_STACK_SIZE = 64 * 1024;
+void* g_signal_stack = nullptr;
+stack_t g_old_signal_stack;
+pid_t g_profiled_tid = 0;
+
+/*!
+ * Get the end of the stack containing rsp, so we don't copy past it.
+ * Returns 0 if rsp isn't in a stack we know about.
+ */
+u64 stack_limit(u64 rsp) {
+  u64 ee_lo = g_buffer->ee_base;
+  u64 ee_hi = ee_lo + EE_MAIN_MEM_SIZE;
+  if (ee_lo && rsp >= ee_lo && rsp < ee_hi) {
+    return ee_hi;
+  }
+  if (rsp >= g_stack_lo && rsp < g_stack_hi) {
+    return g_stack_hi;
+  }
+  return 0;
+}
+
+/*!
+ * Take a sample of the interrupted thread. Runs in a signal handler, so this can't lock or
+ * allocate.
+ */
+void sample_handler(int sig, siginfo_t* info, void* context) {
+  (void)sig;
+  (void)info;
+  auto* buffer = g_buffer;
+  if (!buffer) {
+    return;
+  }
+  auto* uc = (ucontext_t*)context;
+  u64 rsp = uc->uc_mcontext.gregs[REG_RSP];
+  u64 idx = buffer->write_count.load(std::memory_order_relaxed);
+  auto& sample = buffer->samples[idx % PROFILER_SAMPLE_COUNT];
+  sample.rip = uc->uc_mcontext.gregs[REG_RIP];
+
+  u64 words = 0;
+  u64 limit = stack_limit(rsp);
+  if (limit > rsp) {
+    words = std::min(u64(PROFILER_STACK_WORDS), (limit - rsp) / 8);
+  }
+  auto* stack = (const u64*)rsp;
+  for (u64 i = 0; i < words; i++) {
+    sample.stack[i] = stack[i];
+  }
+  sample.stack_words = words;
+  buffer->write_count.store(idx + 1, std::memory_order_release);
+}
+
+/*!
+ * Create the sample buffer. It is shared with a memfd if possible, so the debugger can read it.
+ */
+bool create_buffer() {
+  void* mem = MAP_FAILED;
+  int fd = memfd_create(PROFILER_SHARED_NAME, MFD_CLOEXEC);
+  if (fd >= 0 && ftruncate(fd, sizeof(ProfilerBuffer)) == 0) {
+    // the fd stays open, so the debugger can find it in /proc.
+    mem = mmap(nullptr, sizeof(ProfilerBuffer), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  }
+  if (mem == MAP_FAILED) {
+    lg::warn("[Profiler] Failed to create shared sample buffer, the compiler can't read it: {}",
+             strerror(errno));
+    if (fd >= 0) {
+      close(fd);
+    }
+    mem = mmap(nullptr, sizeof(ProfilerBuffer), PROT_READ | PROT_WRITE,
+               MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+    if (mem == MAP_FAILED) {
+      lg::error("[Profiler] Failed to allocate sample buffer: {}", strerror(errno));
+      return false;
+    }
+  }
+
+  g_buffer = new (mem) ProfilerBuffer;
+  g_buffer->magic = PROFILER_MAGIC;
+  return true;
+}
+
+void install_handler() {
+  static bool installed = false;
+  if (installed) {
+    return;
+  }
+  struct sigaction action = {};
+  action.sa_sigaction = sample_handler;
+  sigemptyset(&action.sa_mask);
+  // don't make the runtime's system calls fail because we interrupted them.
+  action.sa_flags = SA_SIGINFO | SA_RESTART | SA_ONSTACK;
+  if (sigaction(PROFILER_SIGNAL, &action, nullptr) < 0) {
+    lg::error("[Profiler] Failed to install signal handler: {}", strerror(errno));
+    return;
+  }
+  installed = true;
+}
+
+/*!
+ * Run signal handlers for the calling thread on the profiler's signal stack.
+ */
+bool install_signal_stack() {
+  if (!g_signal_stack) {
+    g_signal_stack = mmap(nullptr, SIGNAL_STACK_SIZE, PROT_READ | PROT_WRITE,
+                          MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+    if (g_signal_stack == MAP_FAILED) {
+      g_signal_stack = nullptr;
+      lg::error("[Profiler] Failed to allocate signal stack: {}", strerror(errno));
+      return false;
+    }
+  }
+
+  stack_t ss = {};
+  ss.ss_sp = g_signal_stack;
+  ss.ss_size = SIGNAL_STACK_SIZE;
+  if (sigaltstack(&ss, &g_old_signal_stack) < 0) {
+    lg::error("[Profiler] Failed to set signal stack: {}", strerror(errno));
+    return false;
+  }
+  g_profiled_tid = syscall(SYS_gettid);
+  return true;
+}
+
+/*!
+ * Put back the signal stack the profiled thread had before. Only works from that thread.
+ */
+void remove_signal_stack() {
+  if (g_profiled_tid && g_profiled_tid == syscall(SYS_gettid)) {
+    sigaltstack(&g_old_signal_stack, nullptr);
+    g_profiled_tid = 0;
+  }
+}
+#endif
+}  // namespace
+
+/*!
+ * Start sampling the calling thread hz times per second. Previous samples are discarded.
+ * Returns false if the profiler can't run.
+ */
+bool sampling_profiler_start(u32 hz) {
+#ifdef __linux__
+  if (g_running) {
+    sampling_profiler_stop();
+  }
+  if (!hz) {
+    hz = PROFILER_DEFAULT_HZ;
+  }
+  if (!g_buffer && !create_buffer()) {
+    return false;
+  }
+  if (!install_signal_stack()) {
+    return false;
+  }
+  install_handler();
+
+  pthread_attr_t attr;
+  if (pthread_getattr_np(pthread_self(), &attr) == 0) {
+    void* stack_addr = nullptr;
+    size_t stack_size = 0;
+    pthread_attr_getstack(&attr, &stack_addr, &stack_size);
+    pthread_attr_destroy(&attr);
+    g_stack_lo = (u64)stack_addr;
+    g_stack_hi = g_stack_lo + stack_size;
+  }
+
+  g_buffer->ee_base = (u64)g_ee_main_mem;
+  g_buffer->write_count.store(0);
+
+  sigevent event = {};
+  event.sigev_notify = SIGEV_THREAD_ID;
+  event.sigev_signo = PROFILER_SIGNAL;
+  event.sigev_notify_thread_id = syscall(SYS_gettid);
+  if (timer_create(CLOCK_MONOTONIC, &event, &g_timer) < 0) {
+    lg::error("[Profiler] Failed to create timer: {}", strerror(errno));
+    remove_signal_stack();
+    return false;
+  }
+
+  itimerspec period = {};
+  s64 period_ns = std::max(s64(1000000000) / hz, s64(1000));
+  period.it_interval.tv_sec = period_ns / 1000000000;
+  period.it_interval.tv_nsec = period_ns % 1000000000;
+  period.it_value = period.it_interval;
+  if (timer_settime(g_timer, 0, &period, nullptr) < 0) {
+    lg::error("[Profiler] Failed to start timer: {}", strerror(errno));
+    timer_delete(g_timer);
+    remove_signal_stack();
+    return false;
+  }
+
+  g_buffer->hz = hz;
+  g_running = true;
+  lg::info("[Profiler] Sampling at {} Hz", hz);
+  return true;
+#else
+  (void)hz;
+  lg::warn("[Profiler] The sampling profiler is not supported on this platform");
+  return false;
+#endif
+}
+
+/*!
+ * Stop sampling. The samples stay in the buffer until the profiler is started again.
+ */
+void sampling_profiler_stop() {
+#ifdef __linux__
+  if (!g_running) {
+    return;
+  }
+  timer_delete(g_timer);
+  remove_signal_stack();
+  g_buffer->hz = 0;
+  g_running = false;
+  lg::info("[Profiler] Stopped after {} samples", g_buffer->write_count.load());
+#endif
+}
+
+bool sampling_profiler_running() {
+  return g_running;
+}
+
+/*!
+ * Get the sample buffer, or nullptr if the profiler was never started.
+ */
+const ProfilerBuffer* sampling_profiler_buffer() {
+  return g_buffer;
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+/*!
+ * @file sampling_profiler.h
+ * Periodically samples where a thread is running, for profiling GOAL code.
+ */
+
+#ifndef JAK1_SAMPLING_PROFILER_H
+#define JAK1_SAMPLING_PROFILER_H
+
+#include "common/common_types.h"
+#include "common/profiler_common.h"
+
+bool sampling_profiler_start(u32 hz);
+void sampling_profiler_stop();
+bool sampling_profiler_running();
+const ProfilerBuffer* sampling_profiler_buffer();
+
+#endif  // JAK1_SAMPLING_PROFILER_H
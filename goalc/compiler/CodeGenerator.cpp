@@ -5,6 +5,7 @@
  * Currently owns the logic for emitting the function prologues/epilogues and stack spill ops.
  */
 
+#include <unordered_map>
 #include <unordered_set>
 #include "goalc/debugger/DebugInfo.h"
 #include "third-party/fmt/core.h"
@@ -35,8 +36,19 @@ std::vector<u8> CodeGenerator::run(const TypeSystem* ts) {
     m_gen.add_function_to_seg(f->segment, &m_debug_info->add_function(f->name()));
   }
 
-  // next, add all static objects.
+  // next, add all static objects. Immutable objects with the same contents share one copy.
+  std::unordered_map<std::string, const StaticObject*> interned_statics;
   for (auto& static_obj : m_fe->statics()) {
+    auto key = static_obj->get_intern_key();
+    if (!key.empty()) {
+      auto existing = interned_statics.find(key);
+      if (existing != interned_statics.end()) {
+        static_obj->rec = existing->second->rec;
+        m_static_bytes_saved += m_gen.get_static_data(static_obj->rec).size();
+        continue;
+      }
+      interned_statics[key] = static_obj.get();
+    }
     static_obj->generate(&m_gen);
   }
 
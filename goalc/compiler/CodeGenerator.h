@@ -17,6 +17,7 @@ class CodeGenerator {
  public:
   CodeGenerator(FileEnv* env, DebugInfo* debug_info);
   std::vector<u8> run(const TypeSystem* ts);
+  int static_bytes_saved() const { return m_static_bytes_saved; }
 
  private:
   void do_function(FunctionEnv* env, int f_idx);
@@ -25,4 +26,5 @@ class CodeGenerator {
   emitter::ObjectGenerator m_gen;
   FileEnv* m_fe = nullptr;
   DebugInfo* m_debug_info = nullptr;
+  int m_static_bytes_saved = 0;
 };
@@ -4,6 +4,9 @@
 #include "goalc/regalloc/allocate.h"
 #include "third-party/fmt/core.h"
 #include "CompilerException.h"
+#include "common/util/Timer.h"
+#include "common/util/parallel_for.h"
+#include <algorithm>
 #include <chrono>
 #include <thread>
 
@@ -149,9 +152,16 @@ Val* Compiler::compile_error_guard(const goos::Object& code, Env* env) {
   }
 }
 
+/*!
+ * Run register allocation on all functions in an object file. Each function is allocated
+ * independently, so this is done in parallel. The results are applied in order once all are done.
+ */
 void Compiler::color_object_file(FileEnv* env) {
-  for (auto& f : env->functions()) {
-    AllocationInput input;
+  auto& functions = env->functions();
+  std::vector<AllocationInput> inputs(functions.size());
+  for (size_t fi = 0; fi < functions.size(); fi++) {
+    auto& f = functions.at(fi);
+    auto& input = inputs.at(fi);
     input.is_asm_function = f->is_asm_func;
     for (auto& i : f->code()) {
       input.instructions.push_back(i->to_rai());
@@ -168,8 +178,37 @@ void Compiler::color_object_file(FileEnv* env) {
       input.debug_settings.print_analysis = true;
       input.debug_settings.allocate_log_level = 2;
     }
+  }
 
-    f->set_allocations(allocate_registers(input));
+  std::vector<AllocationResult> results(functions.size());
+  std::vector<double> times_ms(functions.size());
+  // the debug prints would be interleaved, so only use one thread if they are on.
+  int max_threads = m_settings.debug_print_regalloc ? 1 : -1;
+  parallel_for(
+      functions.size(),
+      [&](size_t i) {
+        Timer timer;
+        results.at(i) = allocate_registers(inputs.at(i));
+        times_ms.at(i) = timer.getMs();
+      },
+      max_threads);
+
+  for (size_t i = 0; i < functions.size(); i++) {
+    functions.at(i)->set_allocations(std::move(results.at(i)));
+  }
+
+  if (m_settings.print_timing) {
+    // print the slowest functions.
+    std::vector<size_t> order(functions.size());
+    for (size_t i = 0; i < order.size(); i++) {
+      order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(),
+                     [&](size_t a, size_t b) { return times_ms.at(a) > times_ms.at(b); });
+    for (size_t i = 0; i < order.size() && i < 10; i++) {
+      printf("C: %36s %5d instrs %8.3f ms\n", functions.at(order[i])->name().c_str(),
+             (int)inputs.at(order[i]).instructions.size(), times_ms.at(order[i]));
+    }
   }
 }
 
@@ -180,6 +219,7 @@ std::vector<u8> Compiler::codegen_object_file(FileEnv* env) {
     CodeGenerator gen(env, debug_info);
     bool ok = true;
     auto result = gen.run(&m_ts);
+    m_static_bytes_saved[env->name()] = gen.static_bytes_saved();
     for (auto& f : env->functions()) {
       if (f->settings.print_asm) {
         fmt::print("{}\n", debug_info->disassemble_function_by_name(f->name(), &ok));
@@ -199,6 +239,7 @@ bool Compiler::codegen_and_disassemble_object_file(FileEnv* env,
   debug_info->clear();
   CodeGenerator gen(env, debug_info);
   *data_out = gen.run(&m_ts);
+  m_static_bytes_saved[env->name()] = gen.static_bytes_saved();
   bool ok = true;
   *asm_out = debug_info->disassemble_all_functions(&ok);
   return ok;
@@ -153,6 +153,8 @@ class Compiler {
   std::unordered_map<std::string, GoalEnum> m_enums;
   std::unordered_map<std::shared_ptr<goos::SymbolObject>, goos::Object> m_global_constants;
   std::unordered_map<std::shared_ptr<goos::SymbolObject>, LambdaVal*> m_inlineable_functions;
+  // bytes of static data that were shared instead of duplicated, by object file name
+  std::unordered_map<std::string, int> m_static_bytes_saved;
   CompilerSettings m_settings;
   bool m_throw_on_define_extern_redefinition = false;
   MathMode get_math_mode(const TypeSpec& ts);
@@ -328,6 +330,7 @@ class Compiler {
   Val* compile_asm_abs_vf(const goos::Object& form, const goos::Object& rest, Env* env);
 
   Val* compile_asm_blend_vf(const goos::Object& form, const goos::Object& rest, Env* env);
+  Val* compile_asm_dot_vf(const goos::Object& form, const goos::Object& rest, Env* env);
 
   // Atoms
 
@@ -348,6 +351,7 @@ class Compiler {
   Val* compile_listen_to_target(const goos::Object& form, const goos::Object& rest, Env* env);
   Val* compile_reset_target(const goos::Object& form, const goos::Object& rest, Env* env);
   Val* compile_poke(const goos::Object& form, const goos::Object& rest, Env* env);
+  Val* compile_listener_stats(const goos::Object& form, const goos::Object& rest, Env* env);
   Val* compile_gs(const goos::Object& form, const goos::Object& rest, Env* env);
   Val* compile_set_config(const goos::Object& form, const goos::Object& rest, Env* env);
   Val* compile_in_package(const goos::Object& form, const goos::Object& rest, Env* env);
@@ -376,6 +380,7 @@ class Compiler {
   Val* compile_disasm(const goos::Object& form, const goos::Object& rest, Env* env);
   Val* compile_bp(const goos::Object& form, const goos::Object& rest, Env* env);
   Val* compile_ubp(const goos::Object& form, const goos::Object& rest, Env* env);
+  Val* compile_prof(const goos::Object& form, const goos::Object& rest, Env* env);
   u32 parse_address_spec(const goos::Object& form);
 
   // Macro
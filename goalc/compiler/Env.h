@@ -173,7 +173,7 @@ class FunctionEnv : public DeclareEnv {
   int max_vars() const { return m_iregs.size(); }
   const std::vector<IRegConstraint>& constraints() { return m_constraints; }
   void constrain(const IRegConstraint& c) { m_constraints.push_back(c); }
-  void set_allocations(const AllocationResult& result) { m_regalloc_result = result; }
+  void set_allocations(AllocationResult result) { m_regalloc_result = std::move(result); }
   RegVal* lexical_lookup(goos::Object sym) override;
   const AllocationResult& alloc_result() { return m_regalloc_result; }
   bool needs_aligned_stack() const { return m_aligned_stack_required; }
@@ -597,6 +597,80 @@ void IR_IntegerMath::do_codegen(emitter::ObjectGenerator* gen,
   }
 }
 
+/////////////////////
+// IntegerMathImm
+/////////////////////
+
+IR_IntegerMathImm::IR_IntegerMathImm(IntegerMathKind kind, RegVal* dest, s64 imm)
+    : m_kind(kind), m_dest(dest), m_imm(imm) {
+  assert(can_use_imm(kind, imm));
+}
+
+/*!
+ * Can this operation be done with this constant as an immediate?
+ */
+bool IR_IntegerMathImm::can_use_imm(IntegerMathKind kind, s64 imm) {
+  switch (kind) {
+    case IntegerMathKind::ADD_64:
+    case IntegerMathKind::SUB_64:
+    case IntegerMathKind::AND_64:
+    case IntegerMathKind::OR_64:
+    case IntegerMathKind::XOR_64:
+      return imm >= INT32_MIN && imm <= INT32_MAX;
+    default:
+      return false;
+  }
+}
+
+std::string IR_IntegerMathImm::print() {
+  switch (m_kind) {
+    case IntegerMathKind::ADD_64:
+      return fmt::format("addi {}, {}", m_dest->print(), m_imm);
+    case IntegerMathKind::SUB_64:
+      return fmt::format("subi {}, {}", m_dest->print(), m_imm);
+    case IntegerMathKind::AND_64:
+      return fmt::format("and {}, {}", m_dest->print(), m_imm);
+    case IntegerMathKind::OR_64:
+      return fmt::format("or {}, {}", m_dest->print(), m_imm);
+    case IntegerMathKind::XOR_64:
+      return fmt::format("xor {}, {}", m_dest->print(), m_imm);
+    default:
+      throw std::runtime_error("Unsupported IntegerMathKind");
+  }
+}
+
+RegAllocInstr IR_IntegerMathImm::to_rai() {
+  RegAllocInstr rai;
+  rai.write.push_back(m_dest->ireg());
+  rai.read.push_back(m_dest->ireg());
+  return rai;
+}
+
+void IR_IntegerMathImm::do_codegen(emitter::ObjectGenerator* gen,
+                                   const AllocationResult& allocs,
+                                   emitter::IR_Record irec) {
+  auto dest = get_reg(m_dest, allocs, irec);
+  switch (m_kind) {
+    case IntegerMathKind::ADD_64:
+      gen->add_instr(IGen::add_gpr64_imm(dest, m_imm), irec);
+      break;
+    case IntegerMathKind::SUB_64:
+      gen->add_instr(IGen::sub_gpr64_imm(dest, m_imm), irec);
+      break;
+    case IntegerMathKind::AND_64:
+      gen->add_instr(IGen::and_gpr64_imm(dest, m_imm), irec);
+      break;
+    case IntegerMathKind::OR_64:
+      gen->add_instr(IGen::or_gpr64_imm(dest, m_imm), irec);
+      break;
+    case IntegerMathKind::XOR_64:
+      gen->add_instr(IGen::xor_gpr64_imm(dest, m_imm), irec);
+      break;
+    default:
+      assert(false);
+  }
+}
+
 /////////////////////
 // FloatMath
 /////////////////////
@@ -1422,6 +1496,37 @@ void IR_BlendVF::do_codegen(emitter::ObjectGenerator* gen,
   gen->add_instr(IGen::blend_vf(dst, src1, src2, m_mask), irec);
 }
 
+IR_DotVF::IR_DotVF(bool use_color,
+                   const RegVal* dst,
+                   const RegVal* src1,
+                   const RegVal* src2,
+                   u8 mask)
+    : IR_Asm(use_color), m_dst(dst), m_src1(src1), m_src2(src2), m_mask(mask) {}
+
+std::string IR_DotVF::print() {
+  return fmt::format(".dot.vf{} {}, {}, {}, {}", get_color_suffix_string(), m_dst->print(),
+                     m_src1->print(), m_src2->print(), m_mask);
+}
+
+RegAllocInstr IR_DotVF::to_rai() {
+  RegAllocInstr rai;
+  if (m_use_coloring) {
+    rai.write.push_back(m_dst->ireg());
+    rai.read.push_back(m_src1->ireg());
+    rai.read.push_back(m_src2->ireg());
+  }
+  return rai;
+}
+
+void IR_DotVF::do_codegen(emitter::ObjectGenerator* gen,
+                          const AllocationResult& allocs,
+                          emitter::IR_Record irec) {
+  auto dst = get_reg_asm(m_dst, allocs, irec, m_use_coloring);
+  auto src1 = get_reg_asm(m_src1, allocs, irec, m_use_coloring);
+  auto src2 = get_reg_asm(m_src2, allocs, irec, m_use_coloring);
+  gen->add_instr(IGen::dot_vf(dst, src1, src2, m_mask), irec);
+}
+
 IR_SplatVF::IR_SplatVF(bool use_color,
                        const RegVal* dst,
                        const RegVal* src,
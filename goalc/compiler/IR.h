@@ -212,6 +212,28 @@ class IR_IntegerMath : public IR {
   u8 m_shift_amount = 0;
 };
 
+/*!
+ * Integer math with a constant second argument, which is encoded in the instruction instead of
+ * being loaded into a register. Only supports ADD_64, SUB_64, AND_64, OR_64 and XOR_64 with
+ * constants that fit in a sign extended 32-bit immediate.
+ */
+class IR_IntegerMathImm : public IR {
+ public:
+  IR_IntegerMathImm(IntegerMathKind kind, RegVal* dest, s64 imm);
+  static bool can_use_imm(IntegerMathKind kind, s64 imm);
+  std::string print() override;
+  RegAllocInstr to_rai() override;
+  void do_codegen(emitter::ObjectGenerator* gen,
+                  const AllocationResult& allocs,
+                  emitter::IR_Record irec) override;
+  IntegerMathKind get_kind() const { return m_kind; }
+
+ protected:
+  IntegerMathKind m_kind;
+  RegVal* m_dest;
+  s64 m_imm = 0;
+};
+
 enum class FloatMathKind { DIV_SS, MUL_SS, ADD_SS, SUB_SS, MIN_SS, MAX_SS };
 
 class IR_FloatMath : public IR {
@@ -552,6 +574,22 @@ class IR_BlendVF : public IR_Asm {
   u8 m_mask = 0xff;
 };
 
+class IR_DotVF : public IR_Asm {
+ public:
+  IR_DotVF(bool use_color, const RegVal* dst, const RegVal* src1, const RegVal* src2, u8 mask);
+  std::string print() override;
+  RegAllocInstr to_rai() override;
+  void do_codegen(emitter::ObjectGenerator* gen,
+                  const AllocationResult& allocs,
+                  emitter::IR_Record irec) override;
+
+ protected:
+  const RegVal* m_dst = nullptr;
+  const RegVal* m_src1 = nullptr;
+  const RegVal* m_src2 = nullptr;
+  u8 m_mask = 0xff;
+};
+
 class IR_SplatVF : public IR_Asm {
  public:
   IR_SplatVF(bool use_color,
@@ -43,6 +43,13 @@ void StaticString::generate(emitter::ObjectGenerator* gen) {
   d.push_back(0);
 }
 
+/*!
+ * String constants are never modified, so identical strings in a segment can share data.
+ */
+std::string StaticString::get_intern_key() const {
+  return fmt::format("string {} {}", seg, text);
+}
+
 ////////////////
 // StaticFloat
 ////////////////
@@ -68,6 +75,16 @@ int StaticFloat::get_addr_offset() const {
   return 0;
 }
 
+/*!
+ * Floats are only loaded, so identical floats in a segment can share data. The bits are compared
+ * so -0.0 and 0.0 aren't merged.
+ */
+std::string StaticFloat::get_intern_key() const {
+  u32 bits;
+  memcpy(&bits, &value, sizeof(u32));
+  return fmt::format("float {} {:08x}", seg, bits);
+}
+
 std::string StaticFloat::print() const {
   return fmt::format("(sf {})", value);
 }
@@ -22,6 +22,8 @@ class StaticObject {
   virtual LoadInfo get_load_info() const = 0;
   virtual void generate(emitter::ObjectGenerator* gen) = 0;
   virtual int get_addr_offset() const = 0;
+  // objects with the same non-empty key share a single copy of their data. Only for immutable data.
+  virtual std::string get_intern_key() const { return {}; }
   virtual ~StaticObject() = default;
 
   emitter::StaticRecord rec;
@@ -36,6 +38,7 @@ class StaticFloat : public StaticObject {
   LoadInfo get_load_info() const override;
   void generate(emitter::ObjectGenerator* gen) override;
   int get_addr_offset() const override;
+  std::string get_intern_key() const override;
 };
 
 class StaticStructure : public StaticObject {
@@ -82,6 +85,7 @@ class StaticString : public StaticBasic {
   std::string text;
   std::string print() const override;
   void generate(emitter::ObjectGenerator* gen) override;
+  std::string get_intern_key() const override;
 };
 
 /*!
@@ -133,6 +133,9 @@ RegVal* MemoryOffsetConstantVal::to_reg(Env* fe) {
 
   if (final_offset == 0) {
     fe->emit_ir<IR_RegSet>(re, final_base->to_gpr(fe));
+  } else if (IR_IntegerMathImm::can_use_imm(IntegerMathKind::ADD_64, final_offset)) {
+    fe->emit_ir<IR_RegSet>(re, final_base->to_gpr(fe));
+    fe->emit_ir<IR_IntegerMathImm>(IntegerMathKind::ADD_64, re, final_offset);
   } else {
     fe->emit(std::make_unique<IR_LoadConstant64>(re, int64_t(final_offset)));
     fe->emit(std::make_unique<IR_IntegerMath>(IntegerMathKind::ADD_64, re, final_base->to_gpr(fe)));
@@ -551,6 +551,52 @@ Val* Compiler::compile_asm_blend_vf(const goos::Object& form, const goos::Object
   return get_none();
 }
 
+/*!
+ * Dot product of two vector floats. The destination can be a vector float or a float register, and
+ * gets the result in all elements.
+ */
+Val* Compiler::compile_asm_dot_vf(const goos::Object& form, const goos::Object& rest, Env* env) {
+  auto args = get_va(form, rest);
+  va_check(
+      form, args, {{}, {}, {}},
+      {{"color", {false, goos::ObjectType::SYMBOL}}, {"mask", {false, goos::ObjectType::INTEGER}}});
+  bool color = true;
+  if (args.has_named("color")) {
+    color = get_true_or_false(form, args.named.at("color"));
+  }
+
+  auto dest = compile_error_guard(args.unnamed.at(0), env)->to_reg(env);
+  if (!dest->settable() || (dest->ireg().reg_class != RegClass::VECTOR_FLOAT &&
+                            dest->ireg().reg_class != RegClass::FLOAT)) {
+    throw_compiler_error(form, "Invalid destination register for .dot.vf. Got a {}.",
+                         dest->print());
+  }
+
+  auto src1 = compile_error_guard(args.unnamed.at(1), env)->to_reg(env);
+  if (src1->ireg().reg_class != RegClass::VECTOR_FLOAT) {
+    throw_compiler_error(form, "Invalid first source register for .dot.vf. Got a {}.",
+                         src1->print());
+  }
+
+  auto src2 = compile_error_guard(args.unnamed.at(2), env)->to_reg(env);
+  if (src2->ireg().reg_class != RegClass::VECTOR_FLOAT) {
+    throw_compiler_error(form, "Invalid second source register for .dot.vf. Got a {}.",
+                         src2->print());
+  }
+
+  u8 mask = 0b1111;
+  if (args.has_named("mask")) {
+    mask = args.named.at("mask").as_int();
+    if (mask > 15) {
+      throw_compiler_error(form, "The value {} is out of range for a dot mask (0-15 inclusive).",
+                           mask);
+    }
+  }
+
+  env->emit_ir<IR_DotVF>(color, dest, src1, src2, mask);
+  return get_none();
+}
+
 Val* Compiler::compile_asm_vf_math3(const goos::Object& form,
                                     const goos::Object& rest,
                                     IR_VFMath3Asm::Kind kind,
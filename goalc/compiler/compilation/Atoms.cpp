@@ -63,6 +63,7 @@ static const std::unordered_map<
 
         {".abs.vf", &Compiler::compile_asm_abs_vf},
         {".blend.vf", &Compiler::compile_asm_blend_vf},
+        {".dot.vf", &Compiler::compile_asm_dot_vf},
 
         // BLOCK FORMS
         {"top-level", &Compiler::compile_top_level},
@@ -81,6 +82,7 @@ static const std::unordered_map<
         {"listen-to-target", &Compiler::compile_listen_to_target},
         {"reset-target", &Compiler::compile_reset_target},
         {":status", &Compiler::compile_poke},
+        {"listener-stats", &Compiler::compile_listener_stats},
         {"in-package", &Compiler::compile_in_package},
 
         // CONDITIONAL COMPILATION
@@ -110,6 +112,7 @@ static const std::unordered_map<
         {":disasm", &Compiler::compile_disasm},
         {":bp", &Compiler::compile_bp},
         {":ubp", &Compiler::compile_ubp},
+        {":prof", &Compiler::compile_prof},
 
         // TYPE
         {"deftype", &Compiler::compile_deftype},
@@ -254,6 +254,29 @@ Val* Compiler::compile_poke(const goos::Object& form, const goos::Object& rest,
   return get_none();
 }
 
+/*!
+ * Print round trip times and throughput of messages sent to the target.
+ * Optionally takes a :reset argument to clear the stats after printing them.
+ */
+Val* Compiler::compile_listener_stats(const goos::Object& form,
+                                      const goos::Object& rest,
+                                      Env* env) {
+  (void)env;
+  bool reset = false;
+  for_each_in_list(rest, [&](const goos::Object& o) {
+    if (o.is_symbol() && symbol_string(o) == ":reset") {
+      reset = true;
+    } else {
+      throw_compiler_error(form, "invalid argument to listener-stats: \"{}\"", o.print());
+    }
+  });
+  fmt::print("{}", m_listener.get_stats().print());
+  if (reset) {
+    m_listener.reset_stats();
+  }
+  return get_none();
+}
+
 /*!
  * Enter a goos REPL.
  */
@@ -296,6 +319,7 @@ Val* Compiler::compile_build_dgo(const goos::Object& form, const goos::Object& r
   va_check(form, args, {goos::ObjectType::STRING}, {});
   auto dgo_desc = pair_cdr(m_goos.reader.read_from_file({args.unnamed.at(0).as_string()->data}));
 
+  std::vector<DgoDescription> dgos;
   for_each_in_list(dgo_desc, [&](const goos::Object& dgo) {
     DgoDescription desc;
     auto first = pair_car(dgo);
@@ -318,8 +342,24 @@ Val* Compiler::compile_build_dgo(const goos::Object& form, const goos::Object& r
       }
     });
 
-    build_dgo(desc);
+    dgos.push_back(std::move(desc));
   });
 
+  build_dgos(dgos);
+
+  // report the static data shared by objects compiled in this session.
+  for (auto& desc : dgos) {
+    int saved = 0;
+    for (auto& entry : desc.entries) {
+      auto obj_name = entry.file_name.substr(0, entry.file_name.find_last_of('.'));
+      auto it = m_static_bytes_saved.find(obj_name);
+      if (it != m_static_bytes_saved.end()) {
+        saved += it->second;
+      }
+    }
+    if (saved) {
+      printf("DGO %s: %d bytes of duplicate static data removed\n", desc.dgo_name.c_str(), saved);
+    }
+  }
   return get_none();
 }
\ No newline at end of file
@@ -133,7 +133,7 @@ Val* Compiler::compile_break(const goos::Object& form, const goos::Object& rest,
 
 Val* Compiler::compile_dump_all(const goos::Object& form, const goos::Object& rest, Env* env) {
   (void)env;
-  if (!m_debugger.is_halted()) {
+  if (!m_debugger.is_memory_accessible()) {
     fmt::print("Couldn't dump memory. Must be attached and halted.\n");
     return get_none();
   }
@@ -227,7 +227,7 @@ Val* Compiler::compile_pm(const goos::Object& form, const goos::Object& rest, En
     }
   }
 
-  if (!m_debugger.is_halted()) {
+  if (!m_debugger.is_memory_accessible()) {
     throw_compiler_error(
         form, "Cannot print memory, the debugger must be connected and the target must be halted.");
   }
@@ -325,7 +325,7 @@ Val* Compiler::compile_disasm(const goos::Object& form, const goos::Object& rest
   u32 addr = parse_address_spec(args.unnamed.at(0));
   u32 size = args.unnamed.at(1).as_int();
 
-  if (!m_debugger.is_halted()) {
+  if (!m_debugger.is_memory_accessible()) {
     throw_compiler_error(
         form,
         "Cannot disassemble memory, the debugger must be connected and the target must be halted.");
@@ -388,4 +388,40 @@ Val* Compiler::compile_ubp(const goos::Object& form, const goos::Object& rest, E
   m_debugger.remove_addr_breakpoint(addr);
 
   return get_none();
-}
\ No newline at end of file
+}
+
+/*!
+ * Read the samples from the target's sampling profiler and print where the time went.
+ * With :folded, also write the stacks to a file for flamegraph.pl.
+ */
+Val* Compiler::compile_prof(const goos::Object& form, const goos::Object& rest, Env* env) {
+  (void)env;
+  auto args = get_va(form, rest);
+  va_check(form, args, {},
+           {{"lines", {false, goos::ObjectType::INTEGER}},
+            {"folded", {false, goos::ObjectType::STRING}}});
+  int lines = 30;
+  if (args.has_named("lines")) {
+    lines = args.named.at("lines").as_int();
+  }
+
+  ProfileReport report;
+  if (!m_debugger.read_profile(&report)) {
+    return get_none();
+  }
+  if (!report.sample_count()) {
+    fmt::print("The profiler has no samples.\n");
+    return get_none();
+  }
+
+  fmt::print("{}\n", report.print_flat(lines));
+  fmt::print("{}\n", report.print_ir(lines));
+  fmt::print("{}", report.print_tree(1.0));
+
+  if (args.has_named("folded")) {
+    auto& file_name = args.named.at("folded").as_string()->data;
+    file_util::write_text_file(file_name, report.print_folded());
+    fmt::print("Wrote folded stacks to {}\n", file_name);
+  }
+  return get_none();
+}
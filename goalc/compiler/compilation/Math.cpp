@@ -1,5 +1,20 @@
 #include "goalc/compiler/Compiler.h"
 
+namespace {
+/*!
+ * Emit dest = dest op arg. If arg is an integer constant that fits in an immediate, it is encoded in
+ * the instruction instead of being loaded into a register.
+ */
+void emit_integer_math(IntegerMathKind kind, RegVal* dest, Val* arg, Env* env) {
+  auto as_const = dynamic_cast<IntegerConstantVal*>(arg);
+  if (as_const && IR_IntegerMathImm::can_use_imm(kind, as_const->value())) {
+    env->emit_ir<IR_IntegerMathImm>(kind, dest, as_const->value());
+  } else {
+    env->emit_ir<IR_IntegerMath>(kind, dest, arg->to_gpr(env));
+  }
+}
+}  // namespace
+
 MathMode Compiler::get_math_mode(const TypeSpec& ts) {
   if (m_ts.typecheck(m_ts.make_typespec("binteger"), ts, "", false, false)) {
     return MATH_BINT;
@@ -123,10 +138,9 @@ Val* Compiler::compile_add(const goos::Object& form, const goos::Object& rest, E
       env->emit(std::make_unique<IR_RegSet>(result, first_val->to_gpr(env)));
 
       for (size_t i = 1; i < args.unnamed.size(); i++) {
-        env->emit(std::make_unique<IR_IntegerMath>(
+        emit_integer_math(
             IntegerMathKind::ADD_64, result,
-            to_math_type(form, compile_error_guard(args.unnamed.at(i), env), math_type, env)
-                ->to_gpr(env)));
+            to_math_type(form, compile_error_guard(args.unnamed.at(i), env), math_type, env), env);
       }
       return result;
     }
@@ -305,10 +319,10 @@ Val* Compiler::compile_sub(const goos::Object& form, const goos::Object& rest, E
                         ->to_gpr(env)));
 
         for (size_t i = 1; i < args.unnamed.size(); i++) {
-          env->emit(std::make_unique<IR_IntegerMath>(
+          emit_integer_math(
               IntegerMathKind::SUB_64, result,
-              to_math_type(form, compile_error_guard(args.unnamed.at(i), env), math_type, env)
-                  ->to_gpr(env)));
+              to_math_type(form, compile_error_guard(args.unnamed.at(i), env), math_type, env),
+              env);
         }
         return result;
       }
@@ -523,7 +537,7 @@ Val* Compiler::compile_logand(const goos::Object& form, const goos::Object& rest
   auto args = get_va(form, rest);
   va_check(form, args, {{}, {}}, {});
   auto first = compile_error_guard(args.unnamed.at(0), env)->to_gpr(env);
-  auto second = compile_error_guard(args.unnamed.at(1), env)->to_gpr(env);
+  auto second = compile_error_guard(args.unnamed.at(1), env);
   if (get_math_mode(first->type()) != MathMode::MATH_INT ||
       get_math_mode(second->type()) != MathMode::MATH_INT) {
     throw_compiler_error(form, "Cannot logand a {} by a {}.", first->type().print(),
@@ -532,7 +546,7 @@ Val* Compiler::compile_logand(const goos::Object& form, const goos::Object& rest
 
   auto result = env->make_gpr(first->type());
   env->emit(std::make_unique<IR_RegSet>(result, first));
-  env->emit(std::make_unique<IR_IntegerMath>(IntegerMathKind::AND_64, result, second));
+  emit_integer_math(IntegerMathKind::AND_64, result, second, env);
   return result;
 }
 
@@ -540,7 +554,7 @@ Val* Compiler::compile_logior(const goos::Object& form, const goos::Object& rest
   auto args = get_va(form, rest);
   va_check(form, args, {{}, {}}, {});
   auto first = compile_error_guard(args.unnamed.at(0), env)->to_gpr(env);
-  auto second = compile_error_guard(args.unnamed.at(1), env)->to_gpr(env);
+  auto second = compile_error_guard(args.unnamed.at(1), env);
   if (get_math_mode(first->type()) != MathMode::MATH_INT ||
       get_math_mode(second->type()) != MathMode::MATH_INT) {
     throw_compiler_error(form, "Cannot logior a {} by a {}.", first->type().print(),
@@ -549,7 +563,7 @@ Val* Compiler::compile_logior(const goos::Object& form, const goos::Object& rest
 
   auto result = env->make_gpr(first->type());
   env->emit(std::make_unique<IR_RegSet>(result, first));
-  env->emit(std::make_unique<IR_IntegerMath>(IntegerMathKind::OR_64, result, second));
+  emit_integer_math(IntegerMathKind::OR_64, result, second, env);
   return result;
 }
 
@@ -557,7 +571,7 @@ Val* Compiler::compile_logxor(const goos::Object& form, const goos::Object& rest
   auto args = get_va(form, rest);
   va_check(form, args, {{}, {}}, {});
   auto first = compile_error_guard(args.unnamed.at(0), env)->to_gpr(env);
-  auto second = compile_error_guard(args.unnamed.at(1), env)->to_gpr(env);
+  auto second = compile_error_guard(args.unnamed.at(1), env);
   if (get_math_mode(first->type()) != MathMode::MATH_INT ||
       get_math_mode(second->type()) != MathMode::MATH_INT) {
     throw_compiler_error(form, "Cannot logxor a {} by a {}.", first->type().print(),
@@ -566,7 +580,7 @@ Val* Compiler::compile_logxor(const goos::Object& form, const goos::Object& rest
 
   auto result = env->make_gpr(first->type());
   env->emit(std::make_unique<IR_RegSet>(result, first));
-  env->emit(std::make_unique<IR_IntegerMath>(IntegerMathKind::XOR_64, result, second));
+  emit_integer_math(IntegerMathKind::XOR_64, result, second, env);
   return result;
 }
 
@@ -338,7 +338,6 @@ StaticResult Compiler::compile_static_no_eval_for_pairs(const goos::Object& form
   } else if (form.is_empty_list()) {
     return StaticResult::make_symbol("_empty_");
   } else if (form.is_string()) {
-    // todo - this should eventually work with a string pool
     auto obj = std::make_unique<StaticString>(form.as_string()->data, segment);
     auto result = StaticResult::make_structure_reference(obj.get(), m_ts.make_typespec("string"));
     fie->add_static(std::move(obj));
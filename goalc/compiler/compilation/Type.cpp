@@ -560,10 +560,9 @@ Val* Compiler::compile_deref(const goos::Object& form, const goos::Object& _rest
             loc_type, result, ARRAY_DATA_OFFSET + di.stride * constant_index_value);
       } else {
         // the total offset is 12 + stride * idx
-        auto arr_off = compile_integer(ARRAY_DATA_OFFSET, env)->to_gpr(env);
         RegVal* offset = fe->make_gpr(TypeSpec("int"));
         compile_constant_product(offset, index_value, di.stride, env);
-        env->emit_ir<IR_IntegerMath>(IntegerMathKind::ADD_64, offset, arr_off);
+        env->emit_ir<IR_IntegerMathImm>(IntegerMathKind::ADD_64, offset, ARRAY_DATA_OFFSET);
 
         // create a location to deref (so we can do address-of and get this), with pointer type
         loc = fe->alloc_val<MemoryOffsetVal>(loc_type, result, offset);
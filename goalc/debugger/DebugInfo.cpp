@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <utility>
 #include <vector>
 #include "DebugInfo.h"
@@ -22,6 +23,64 @@ std::string FunctionDebugInfo::disassemble_debug_info(bool* had_failure) {
   return result;
 }
 
+/*!
+ * Find the instruction containing the given offset into the function, or nullptr if there isn't
+ * one. The instructions are sorted by offset.
+ */
+const InstructionInfo* FunctionDebugInfo::find_instruction(int offset) const {
+  auto it = std::upper_bound(
+      instructions.begin(), instructions.end(), offset,
+      [](int off, const InstructionInfo& instr) { return off < instr.offset; });
+  if (it == instructions.begin()) {
+    return nullptr;
+  }
+  --it;
+  if (offset >= it->offset + it->instruction.length()) {
+    return nullptr;
+  }
+  return &*it;
+}
+
+void DebugInfo::build_function_index() {
+  m_function_index.clear();
+  for (auto& kv : m_functions) {
+    auto& info = kv.second;
+    m_function_index.push_back({info.seg, info.offset_in_seg, info.offset_in_seg + info.length,
+                                &info});
+  }
+  std::sort(m_function_index.begin(), m_function_index.end(),
+            [](const FunctionRange& a, const FunctionRange& b) {
+              return std::make_pair(a.seg, a.start) < std::make_pair(b.seg, b.start);
+            });
+  m_function_index_valid = true;
+}
+
+/*!
+ * Find the function containing the given offset into a segment. Returns false if there isn't one.
+ */
+bool DebugInfo::lookup_function(FunctionDebugInfo** info, std::string* name, u32 offset, u8 seg) {
+  if (!m_function_index_valid) {
+    build_function_index();
+  }
+
+  // the last function starting at or before offset is the only one that could contain it.
+  auto it = std::upper_bound(m_function_index.begin(), m_function_index.end(),
+                             std::make_pair(seg, offset),
+                             [](const std::pair<u8, u32>& key, const FunctionRange& range) {
+                               return key < std::make_pair(range.seg, range.start);
+                             });
+  if (it == m_function_index.begin()) {
+    return false;
+  }
+  --it;
+  if (it->seg != seg || offset >= it->end) {
+    return false;
+  }
+  *info = it->info;
+  *name = it->info->name;
+  return true;
+}
+
 std::string DebugInfo::disassemble_all_functions(bool* had_failure) {
   std::string result;
   for (auto& kv : m_functions) {
@@ -18,6 +18,7 @@ struct FunctionDebugInfo {
   std::vector<InstructionInfo> instructions;
 
   std::string disassemble_debug_info(bool* had_failure);
+  const InstructionInfo* find_instruction(int offset) const;
 };
 
 class DebugInfo {
@@ -30,28 +31,35 @@ class DebugInfo {
     }
     auto& result = m_functions[name];
     result.name = name;
+    // the offset and length are filled out later, so the index is rebuilt on the next lookup.
+    m_function_index_valid = false;
     return result;
   }
 
-  bool lookup_function(FunctionDebugInfo** info, std::string* name, u32 offset, u8 seg) {
-    for (auto& kv : m_functions) {
-      auto start = kv.second.offset_in_seg;
-      auto end = start + kv.second.length;
-      if (offset >= start && offset < end && seg == kv.second.seg) {
-        *info = &kv.second;
-        *name = kv.first;
-        return true;
-      }
-    }
-    return false;
-  }
+  bool lookup_function(FunctionDebugInfo** info, std::string* name, u32 offset, u8 seg);
 
-  void clear() { m_functions.clear(); }
+  void clear() {
+    m_functions.clear();
+    m_function_index.clear();
+    m_function_index_valid = false;
+  }
 
   std::string disassemble_all_functions(bool* had_failure);
   std::string disassemble_function_by_name(const std::string& name, bool* had_failure);
 
  private:
+  void build_function_index();
+
   std::string m_obj_name;
   std::unordered_map<std::string, FunctionDebugInfo> m_functions;
+
+  // all functions, sorted by segment and offset, for looking up functions by address.
+  struct FunctionRange {
+    u8 seg;
+    u32 start;
+    u32 end;
+    FunctionDebugInfo* info;
+  };
+  std::vector<FunctionRange> m_function_index;
+  bool m_function_index_valid = false;
 };
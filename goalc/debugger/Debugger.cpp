@@ -4,11 +4,13 @@
  * Uses xdbg functions to debug an OpenGOAL target.
  */
 
+#include <algorithm>
 #include <cassert>
 #include "Debugger.h"
 #include "common/util/Timer.h"
 #include "common/goal_constants.h"
 #include "common/symbols.h"
+#include "common/profiler_common.h"
 #include "third-party/fmt/core.h"
 #include "goalc/debugger/disassemble.h"
 #include "goalc/listener/Listener.h"
@@ -134,7 +136,7 @@ bool Debugger::attach_and_break() {
 void Debugger::update_break_info() {
   // todo adjust rip if break instruction????
 
-  m_memory_map = m_listener->build_memory_map();
+  update_memory_map();
   // fmt::print("{}", m_memory_map.print());
   read_symbol_table();
   m_regs_valid = false;
@@ -271,27 +273,41 @@ bool Debugger::do_continue() {
   }
 
   m_expecting_immeidate_break = false;
+  {
+    // set this before continuing, the watcher will clear it if the target stops right away.
+    std::lock_guard<std::mutex> lock(m_watcher_mutex);
+    m_running = true;
+  }
   if (!xdbg::cont_now(m_debug_context.tid)) {
+    std::lock_guard<std::mutex> lock(m_watcher_mutex);
+    m_running = false;
     return false;
-  } else {
-    m_running = true;
-    return true;
   }
+  return true;
 }
 
 /*!
- * Read memory from an attached and halted target.
+ * Can we access the target's memory now? This requires the target to be halted, unless its memory
+ * is shared with us.
+ */
+bool Debugger::is_memory_accessible() const {
+  return is_valid() && is_attached() &&
+         (is_halted() || xdbg::is_memory_shared(m_memory_handle));
+}
+
+/*!
+ * Read memory from an attached target. Must be halted, unless the memory is shared.
  */
 bool Debugger::read_memory(u8* dest_buffer, int size, u32 goal_addr) {
-  assert(is_valid() && is_attached() && is_halted());
+  assert(is_memory_accessible());
   return xdbg::read_goal_memory(dest_buffer, size, goal_addr, m_debug_context, m_memory_handle);
 }
 
 /*!
- * Write the memory of an attached and halted target.
+ * Write the memory of an attached target. Must be halted, unless the memory is shared.
  */
 bool Debugger::write_memory(const u8* src_buffer, int size, u32 goal_addr) {
-  assert(is_valid() && is_attached() && is_halted());
+  assert(is_memory_accessible());
   return xdbg::write_goal_memory(src_buffer, size, goal_addr, m_debug_context, m_memory_handle);
 }
 
@@ -430,6 +446,7 @@ void Debugger::start_watcher() {
   assert(!m_watcher_running);
   m_watcher_running = true;
   m_watcher_should_stop = false;
+  m_watcher_exited = false;
   m_watcher_thread = std::thread(&Debugger::watcher, this);
 }
 
@@ -440,6 +457,12 @@ void Debugger::stop_watcher() {
   assert(m_watcher_running);
   m_watcher_running = false;
   m_watcher_should_stop = true;
+  // the watcher is probably blocked waiting for the target to stop. Keep interrupting it until it
+  // exits, in case an interrupt arrives just before it starts waiting.
+  while (!m_watcher_exited) {
+    xdbg::interrupt_wait(m_watcher_thread);
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
   m_watcher_thread.join();
 }
 
@@ -450,13 +473,13 @@ Debugger::~Debugger() {
 }
 
 /*!
- * The watcher thread.
+ * The watcher thread. Blocks until the target stops, so stops are reported right away.
  */
 void Debugger::watcher() {
   xdbg::SignalInfo signal_info;
   while (!m_watcher_should_stop) {
     // we just sit in a loop, waiting for stops.
-    if (xdbg::check_stopped(m_debug_context.tid, &signal_info)) {
+    if (xdbg::wait_for_stop(m_debug_context.tid, &signal_info)) {
       // the target stopped!
       m_continue_info.valid = false;
 
@@ -478,12 +501,9 @@ void Debugger::watcher() {
         m_watcher_queue.push({signal_info.kind});  // todo, more info?
       }
       m_watcher_cv.notify_one();
-
-    } else {
-      // the target didn't stop.
-      std::this_thread::sleep_for(std::chrono::milliseconds(10));
     }
   }
+  m_watcher_exited = true;
 }
 
 Debugger::SignalInfo Debugger::pop_signal() {
@@ -605,4 +625,133 @@ DebugInfo& Debugger::get_debug_info_for_object(const std::string& object_name) {
   }
 
   return m_debug_info.insert(std::make_pair(object_name, DebugInfo(object_name))).first->second;
-}
\ No newline at end of file
+}
+
+/*!
+ * Rebuild the memory map, if anything was loaded since it was last built.
+ */
+void Debugger::update_memory_map() {
+  auto load_count = m_listener->get_load_count();
+  if (load_count != m_memory_map_load_count) {
+    m_memory_map = m_listener->build_memory_map();
+    m_memory_map_load_count = load_count;
+  }
+}
+
+namespace {
+/*!
+ * Is this a call instruction? GOAL calls functions with call r64.
+ */
+bool is_call(const emitter::Instruction& instr) {
+  return instr.op == 0xff && !instr.op2_set && instr.set_modrm && ((instr.m_modrm >> 3) & 7) == 2;
+}
+}  // namespace
+
+/*!
+ * Figure out where a sampled address is.
+ */
+Debugger::ProfileLocation Debugger::lookup_profile_location(u64 real_addr) {
+  ProfileLocation result;
+  if (real_addr < m_debug_context.base + EE_MAIN_MEM_LOW_PROTECT ||
+      real_addr >= m_debug_context.base + EE_MAIN_MEM_SIZE) {
+    result.name = "[runtime]";
+    return result;
+  }
+
+  u32 goal_addr = real_addr - m_debug_context.base;
+  auto& map_loc = m_memory_map.lookup(goal_addr);
+  if (map_loc.empty) {
+    result.name = "[unknown GOAL code]";
+    return result;
+  }
+
+  u32 obj_offset = goal_addr - map_loc.start_addr;
+  FunctionDebugInfo* info = nullptr;
+  if (!get_debug_info_for_object(map_loc.obj_name)
+           .lookup_function(&info, &result.name, obj_offset, map_loc.seg_id)) {
+    result.name = fmt::format("[{} segment {}]", map_loc.obj_name, map_loc.seg_id);
+    return result;
+  }
+
+  result.in_function = true;
+  int function_offset = obj_offset - info->offset_in_seg;
+  auto* instr = info->find_instruction(function_offset);
+  if (instr && instr->kind == InstructionInfo::Kind::IR && instr->ir_idx >= 0 &&
+      instr->ir_idx < (int)info->irs.size()) {
+    result.ir = info->irs.at(instr->ir_idx);
+  }
+  auto* prev = info->find_instruction(function_offset - 1);
+  result.after_call = prev && prev->offset + prev->instruction.length() == function_offset &&
+                      is_call(prev->instruction);
+  return result;
+}
+
+/*!
+ * Read the samples taken by the runtime's sampling profiler and symbolize them.
+ * Doesn't need the debugger to be attached, but does need a debugging context. The stack of each
+ * sample is rebuilt by looking for words on the stack that point right after a call in a GOAL
+ * function, so it may have extra frames from stale return addresses.
+ */
+bool Debugger::read_profile(ProfileReport* out) {
+  if (!m_context_valid) {
+    fmt::print("[Debugger] Cannot read profile, there is no valid debugging context\n");
+    return false;
+  }
+
+  auto* buffer = (ProfilerBuffer*)xdbg::map_shared_buffer(
+      m_debug_context.tid, PROFILER_SHARED_NAME, sizeof(ProfilerBuffer));
+  if (!buffer) {
+    fmt::print("[Debugger] No profiler samples found. Run (profiler-start) in the target first.\n");
+    return false;
+  }
+  if (buffer->magic != PROFILER_MAGIC || buffer->ee_base != m_debug_context.base) {
+    fmt::print("[Debugger] The profiler samples don't match the target.\n");
+    xdbg::unmap_shared_buffer((u8*)buffer, sizeof(ProfilerBuffer));
+    return false;
+  }
+
+  // copy out the samples, then drop any that the target overwrote while we were copying.
+  u64 end = buffer->write_count.load(std::memory_order_acquire);
+  u64 start = end > PROFILER_SAMPLE_COUNT ? end - PROFILER_SAMPLE_COUNT : 0;
+  std::vector<ProfilerSample> samples;
+  samples.reserve(end - start);
+  for (u64 i = start; i < end; i++) {
+    samples.push_back(buffer->samples[i % PROFILER_SAMPLE_COUNT]);
+  }
+  u64 end_after = buffer->write_count.load(std::memory_order_acquire);
+  xdbg::unmap_shared_buffer((u8*)buffer, sizeof(ProfilerBuffer));
+
+  u64 first_valid = end_after > PROFILER_SAMPLE_COUNT ? end_after - PROFILER_SAMPLE_COUNT : 0;
+  if (end_after < end) {
+    // the profiler was restarted, so none of these are from the same run.
+    first_valid = end;
+  }
+
+  update_memory_map();
+  // most samples land on the same few addresses, so only look each one up once.
+  std::unordered_map<u64, ProfileLocation> locations;
+  auto lookup = [&](u64 addr) -> const ProfileLocation& {
+    auto it = locations.find(addr);
+    if (it == locations.end()) {
+      it = locations.insert({addr, lookup_profile_location(addr)}).first;
+    }
+    return it->second;
+  };
+
+  std::vector<std::string> stack;
+  for (u64 i = std::max(start, first_valid); i < end; i++) {
+    auto& sample = samples.at(i - start);
+    stack.clear();
+    auto& leaf = lookup(sample.rip);
+    stack.push_back(leaf.name);
+    for (u64 w = 0; w < sample.stack_words && w < PROFILER_STACK_WORDS; w++) {
+      auto& caller = lookup(sample.stack[w]);
+      if (caller.in_function && caller.after_call) {
+        stack.push_back(caller.name);
+      }
+    }
+    std::reverse(stack.begin(), stack.end());
+    out->add_sample(stack, leaf.ir);
+  }
+  return true;
+}
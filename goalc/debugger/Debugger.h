@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <unordered_map>
 #include <thread>
 #include <mutex>
@@ -15,6 +16,7 @@
 #include "common/cross_os_debug/xdbg.h"
 #include "goalc/listener/MemoryMap.h"
 #include "DebugInfo.h"
+#include "ProfileReport.h"
 
 namespace listener {
 class Listener;
@@ -44,6 +46,7 @@ class Debugger {
   bool is_valid() const;
   bool is_attached() const;
   bool is_running() const;
+  bool is_memory_accessible() const;
   void detach();
   void invalidate();
   void set_context(u32 s7, uintptr_t base, const std::string& thread_id);
@@ -60,6 +63,7 @@ class Debugger {
   void remove_addr_breakpoint(u32 addr);
   void update_break_info();
   DebugInfo& get_debug_info_for_object(const std::string& object_name);
+  bool read_profile(ProfileReport* out);
   const BreakInfo& get_cached_break_info() { return m_break_info; }
 
   /*!
@@ -119,7 +123,8 @@ class Debugger {
   xdbg::MemoryHandle m_memory_handle;
   xdbg::Regs m_regs_at_break;
 
-  bool m_watcher_should_stop = false;
+  std::atomic<bool> m_watcher_should_stop = {false};
+  std::atomic<bool> m_watcher_exited = {false};
   bool m_watcher_running = false;
   bool m_regs_valid = false;
 
@@ -128,6 +133,16 @@ class Debugger {
   void watcher();
   void update_continue_info();
 
+  // where a sampled address is, for building profiles.
+  struct ProfileLocation {
+    bool in_function = false;  // in a GOAL function we have debug info for
+    bool after_call = false;   // right after a call instruction, so it may be a return address
+    std::string name;
+    std::string ir;  // the IR the address is in, if known
+  };
+  ProfileLocation lookup_profile_location(u64 real_addr);
+  void update_memory_map();
+
   struct Breakpoint {
     u32 goal_addr = 0;  // address to break at
     int id = -1;        // breakpoint ID
@@ -161,12 +176,14 @@ class Debugger {
   void clear_signal_queue();
 
   bool m_context_valid = false;
-  bool m_running = true;
+  // written by the watcher thread when the target stops.
+  std::atomic<bool> m_running = {true};
   bool m_attached = false;
 
   BreakInfo m_break_info;
 
   listener::Listener* m_listener = nullptr;
   listener::MemoryMap m_memory_map;
+  u64 m_memory_map_load_count = UINT64_MAX;  //! listener load count when the map was built
   std::unordered_map<std::string, DebugInfo> m_debug_info;
 };
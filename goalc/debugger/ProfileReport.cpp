@@ -0,0 +1,153 @@
+/*!
+ * @file ProfileReport.cpp
+ * A profile built from the runtime's sampling profiler, after the samples have been symbolized.
+ */
+
+#include <algorithm>
+#include <unordered_set>
+#include "ProfileReport.h"
+#include "third-party/fmt/core.h"
+
+namespace {
+struct CallTreeNode {
+  int count = 0;
+  std::map<std::string, CallTreeNode> children;
+};
+
+double percent(int count, int total) {
+  return total ? 100. * count / total : 0.;
+}
+
+void print_tree_node(const std::string& name,
+                     const CallTreeNode& node,
+                     int depth,
+                     int total,
+                     double min_percent,
+                     std::string* out) {
+  *out += fmt::format("{:6.2f}% {}{}\n", percent(node.count, total), std::string(2 * depth, ' '),
+                      name);
+
+  std::vector<std::pair<const std::string*, const CallTreeNode*>> children;
+  for (auto& child : node.children) {
+    if (percent(child.second.count, total) >= min_percent) {
+      children.emplace_back(&child.first, &child.second);
+    }
+  }
+  std::stable_sort(children.begin(), children.end(), [](const auto& a, const auto& b) {
+    return a.second->count > b.second->count;
+  });
+  for (auto& child : children) {
+    print_tree_node(*child.first, *child.second, depth + 1, total, min_percent, out);
+  }
+}
+}  // namespace
+
+/*!
+ * Add a sample. The stack goes from the outermost caller to the function that was running, and
+ * must not be empty. The leaf_ir is the IR that was running, or empty if unknown.
+ */
+void ProfileReport::add_sample(const std::vector<std::string>& stack, const std::string& leaf_ir) {
+  m_stacks[stack]++;
+  if (!leaf_ir.empty()) {
+    m_ir_counts[stack.back() + ": " + leaf_ir]++;
+  }
+  m_samples++;
+}
+
+/*!
+ * Print the time spent in each function (self) and in each function and the functions it called
+ * (total), sorted by self time.
+ */
+std::string ProfileReport::print_flat(int max_lines) const {
+  std::unordered_map<std::string, int> self, total;
+  for (auto& kv : m_stacks) {
+    self[kv.first.back()] += kv.second;
+    // count recursive functions once per sample.
+    std::unordered_set<std::string> seen;
+    for (auto& frame : kv.first) {
+      if (seen.insert(frame).second) {
+        total[frame] += kv.second;
+      }
+    }
+  }
+
+  std::vector<std::string> names;
+  for (auto& kv : total) {
+    names.push_back(kv.first);
+  }
+  std::sort(names.begin(), names.end(), [&](const std::string& a, const std::string& b) {
+    auto self_a = self[a], self_b = self[b];
+    if (self_a != self_b) {
+      return self_a > self_b;
+    }
+    if (total[a] != total[b]) {
+      return total[a] > total[b];
+    }
+    return a < b;
+  });
+
+  std::string result = fmt::format("  self%  total%  function ({} samples)\n", m_samples);
+  for (int i = 0; i < (int)names.size() && i < max_lines; i++) {
+    auto& name = names[i];
+    result += fmt::format("{:6.2f}% {:6.2f}%  {}\n", percent(self[name], m_samples),
+                          percent(total[name], m_samples), name);
+  }
+  return result;
+}
+
+/*!
+ * Print the IR that was running most often.
+ */
+std::string ProfileReport::print_ir(int max_lines) const {
+  std::vector<std::pair<std::string, int>> irs(m_ir_counts.begin(), m_ir_counts.end());
+  std::sort(irs.begin(), irs.end(), [](const auto& a, const auto& b) {
+    if (a.second != b.second) {
+      return a.second > b.second;
+    }
+    return a.first < b.first;
+  });
+
+  std::string result = "  self%  ir\n";
+  for (int i = 0; i < (int)irs.size() && i < max_lines; i++) {
+    result += fmt::format("{:6.2f}%  {}\n", percent(irs[i].second, m_samples), irs[i].first);
+  }
+  return result;
+}
+
+/*!
+ * Print the call tree, from the outermost callers down. Calls with less than min_percent of the
+ * samples are left out.
+ */
+std::string ProfileReport::print_tree(double min_percent) const {
+  CallTreeNode root;
+  for (auto& kv : m_stacks) {
+    auto* node = &root;
+    node->count += kv.second;
+    for (auto& frame : kv.first) {
+      node = &node->children[frame];
+      node->count += kv.second;
+    }
+  }
+
+  std::string result;
+  print_tree_node("all", root, 0, m_samples, min_percent, &result);
+  return result;
+}
+
+/*!
+ * Print the stacks in the "folded" format used by flamegraph.pl: one line per stack, with frames
+ * separated by semicolons, followed by the number of samples.
+ */
+std::string ProfileReport::print_folded() const {
+  std::string result;
+  for (auto& kv : m_stacks) {
+    for (size_t i = 0; i < kv.first.size(); i++) {
+      if (i) {
+        result.push_back(';');
+      }
+      result += kv.first[i];
+    }
+    result += fmt::format(" {}\n", kv.second);
+  }
+  return result;
+}
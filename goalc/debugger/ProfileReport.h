@@ -0,0 +1,29 @@
+#pragma once
+
+/*!
+ * @file ProfileReport.h
+ * A profile built from the runtime's sampling profiler, after the samples have been symbolized.
+ */
+
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class ProfileReport {
+ public:
+  void add_sample(const std::vector<std::string>& stack, const std::string& leaf_ir);
+  int sample_count() const { return m_samples; }
+
+  std::string print_flat(int max_lines) const;
+  std::string print_ir(int max_lines) const;
+  std::string print_tree(double min_percent) const;
+  std::string print_folded() const;
+
+ private:
+  // call stacks, from the outermost caller to the function that was running, and their counts.
+  std::map<std::vector<std::string>, int> m_stacks;
+  // the IR that was running, for samples in functions with debug info
+  std::unordered_map<std::string, int> m_ir_counts;
+  int m_samples = 0;
+};
@@ -1691,6 +1691,108 @@ class IGen {
     return instr;
   }
 
+  static Instruction and_gpr64_imm8s(Register reg, int64_t imm) {
+    assert(reg.is_gpr());
+    assert(imm >= INT8_MIN && imm <= INT8_MAX);
+    // AND r/m64, imm8 : REX.W + 83 /4 ib
+    Instruction instr(0x83);
+    instr.set_modrm_and_rex(4, reg.hw_id(), 3, true);
+    instr.set(Imm(1, imm));
+    return instr;
+  }
+
+  static Instruction and_gpr64_imm32s(Register reg, int64_t imm) {
+    assert(reg.is_gpr());
+    assert(imm >= INT32_MIN && imm <= INT32_MAX);
+    // AND r/m64, imm32 : REX.W + 81 /4 id
+    Instruction instr(0x81);
+    instr.set_modrm_and_rex(4, reg.hw_id(), 3, true);
+    instr.set(Imm(4, imm));
+    return instr;
+  }
+
+  /*!
+   * and dst, imm. The immediate is sign extended to 64 bits.
+   */
+  static Instruction and_gpr64_imm(Register reg, int64_t imm) {
+    if (imm >= INT8_MIN && imm <= INT8_MAX) {
+      return and_gpr64_imm8s(reg, imm);
+    } else if (imm >= INT32_MIN && imm <= INT32_MAX) {
+      return and_gpr64_imm32s(reg, imm);
+    } else {
+      throw std::runtime_error("Invalid `and` with reg[" + reg.print() + "]/imm[" +
+                               std::to_string(imm) + "]");
+    }
+  }
+
+  static Instruction or_gpr64_imm8s(Register reg, int64_t imm) {
+    assert(reg.is_gpr());
+    assert(imm >= INT8_MIN && imm <= INT8_MAX);
+    // OR r/m64, imm8 : REX.W + 83 /1 ib
+    Instruction instr(0x83);
+    instr.set_modrm_and_rex(1, reg.hw_id(), 3, true);
+    instr.set(Imm(1, imm));
+    return instr;
+  }
+
+  static Instruction or_gpr64_imm32s(Register reg, int64_t imm) {
+    assert(reg.is_gpr());
+    assert(imm >= INT32_MIN && imm <= INT32_MAX);
+    // OR r/m64, imm32 : REX.W + 81 /1 id
+    Instruction instr(0x81);
+    instr.set_modrm_and_rex(1, reg.hw_id(), 3, true);
+    instr.set(Imm(4, imm));
+    return instr;
+  }
+
+  /*!
+   * or dst, imm. The immediate is sign extended to 64 bits.
+   */
+  static Instruction or_gpr64_imm(Register reg, int64_t imm) {
+    if (imm >= INT8_MIN && imm <= INT8_MAX) {
+      return or_gpr64_imm8s(reg, imm);
+    } else if (imm >= INT32_MIN && imm <= INT32_MAX) {
+      return or_gpr64_imm32s(reg, imm);
+    } else {
+      throw std::runtime_error("Invalid `or` with reg[" + reg.print() + "]/imm[" +
+                               std::to_string(imm) + "]");
+    }
+  }
+
+  static Instruction xor_gpr64_imm8s(Register reg, int64_t imm) {
+    assert(reg.is_gpr());
+    assert(imm >= INT8_MIN && imm <= INT8_MAX);
+    // XOR r/m64, imm8 : REX.W + 83 /6 ib
+    Instruction instr(0x83);
+    instr.set_modrm_and_rex(6, reg.hw_id(), 3, true);
+    instr.set(Imm(1, imm));
+    return instr;
+  }
+
+  static Instruction xor_gpr64_imm32s(Register reg, int64_t imm) {
+    assert(reg.is_gpr());
+    assert(imm >= INT32_MIN && imm <= INT32_MAX);
+    // XOR r/m64, imm32 : REX.W + 81 /6 id
+    Instruction instr(0x81);
+    instr.set_modrm_and_rex(6, reg.hw_id(), 3, true);
+    instr.set(Imm(4, imm));
+    return instr;
+  }
+
+  /*!
+   * xor dst, imm. The immediate is sign extended to 64 bits.
+   */
+  static Instruction xor_gpr64_imm(Register reg, int64_t imm) {
+    if (imm >= INT8_MIN && imm <= INT8_MAX) {
+      return xor_gpr64_imm8s(reg, imm);
+    } else if (imm >= INT32_MIN && imm <= INT32_MAX) {
+      return xor_gpr64_imm32s(reg, imm);
+    } else {
+      throw std::runtime_error("Invalid `xor` with reg[" + reg.print() + "]/imm[" +
+                               std::to_string(imm) + "]");
+    }
+  }
+
   /*!
    * Bitwise not a gpr
    */
@@ -2308,6 +2410,23 @@ class IGen {
     instr.set(Imm(1, mask));
     return instr;
   }
+
+  /*!
+   * Dot product of the elements of src1 and src2 selected by mask. The result is written to all
+   * four elements of dst.
+   */
+  static Instruction dot_vf(Register dst, Register src1, Register src2, u8 mask) {
+    assert(!(mask & 0b11110000));
+    assert(dst.is_xmm());
+    assert(src1.is_xmm());
+    assert(src2.is_xmm());
+    Instruction instr(0x40);  // VDPPS
+    instr.set_vex_modrm_and_rex(dst.hw_id(), src2.hw_id(), VEX3::LeadingBytes::P_0F_3A,
+                                src1.hw_id(), false, VexPrefix::P_66);
+    // the upper 4 bits select the inputs, the lower 4 bits select the outputs.
+    instr.set(Imm(1, (mask << 4) | 0b1111));
+    return instr;
+  }
 };
 }  // namespace emitter
 
@@ -31,6 +31,7 @@
 #include <algorithm>
 #include "Listener.h"
 #include "common/versions.h"
+#include "common/util/Timer.h"
 
 #include "third-party/fmt/core.h"
 
@@ -248,7 +249,11 @@ void Listener::receive_func() {
           }
           ack_recv_buff[ack_recv_prog] = '\0';
           assert(ack_recv_prog < 512);
-          got_ack = true;
+          {
+            std::lock_guard<std::mutex> lock(m_ack_mutex);
+            got_ack = true;
+          }
+          m_ack_cv.notify_all();
           last_recvd_id = hdr->msg_id;
           if (last_recvd_id > last_sent_id) {
             printf(
@@ -431,11 +436,16 @@ void Listener::send_buffer(int sz) {
     fprintf(stderr, "[L -> T] sending %d bytes...\n", sz);
   }
 
-  got_ack = false;
+  {
+    std::lock_guard<std::mutex> lock(m_ack_mutex);
+    got_ack = false;
+  }
   waiting_for_ack = true;
+  Timer timer;
+  // write as much as the socket will take at once. Large code messages used to go out in many small
+  // writes, which are each sent as their own packet because of TCP_NODELAY.
   while (wrote < sz) {
-    auto to_send = std::min(512, sz - wrote);
-    auto x = write_to_socket(listen_socket, m_buffer + wrote, to_send);
+    auto x = write_to_socket(listen_socket, m_buffer + wrote, sz - wrote);
     wrote += x > 0 ? x : 0;
   }
 
@@ -444,18 +454,25 @@ void Listener::send_buffer(int sz) {
   }
 
   if (wait_for_ack()) {
+    double ms = timer.getMs();
+    m_stats.messages++;
+    m_stats.bytes_sent += sz;
+    m_stats.total_ms += ms;
+    m_stats.max_ms = std::max(m_stats.max_ms, ms);
     if (debug_listener) {
       printf("ack buff:\n");
       printf("%s\n", ack_recv_buff);
       printf("  OK\n");
     }
   } else {
+    m_stats.timeouts++;
     printf("  Timed out waiting for ack.\n");
   }
 }
 
 /*!
  * Wait for the target to send an ack.
+ * The receive thread wakes us up as soon as it gets one.
  */
 bool Listener::wait_for_ack() {
   // todo, check the message ID.
@@ -464,10 +481,9 @@ bool Listener::wait_for_ack() {
     return false;
   }
 
-  for (int i = 0; i < 2000; i++) {
-    if (got_ack)
-      return true;
-    std::this_thread::sleep_for(std::chrono::microseconds(1000));
+  std::unique_lock<std::mutex> lock(m_ack_mutex);
+  if (m_ack_cv.wait_for(lock, std::chrono::milliseconds(2000), [&] { return got_ack; })) {
+    return true;
   }
 
   waiting_for_ack = false;
@@ -558,6 +574,7 @@ void Listener::add_load(const std::string& name, const LoadEntry& le) {
     printf("[Listener Warning] The runtime has loaded %s twice!\n", name.c_str());
   }
   m_load_entries[name] = le;
+  m_load_count++;
 }
 
 /*!
@@ -568,7 +585,32 @@ void Listener::add_debugger(Debugger* debugger) {
 }
 
 MemoryMap Listener::build_memory_map() {
+  // loads are added by the receive thread.
+  std::lock_guard<std::mutex> lock(rcv_mtx);
   return MemoryMap(m_load_entries);
 }
 
+/*!
+ * Get the number of loads so far. If this hasn't changed, neither has the memory map.
+ */
+u64 Listener::get_load_count() {
+  std::lock_guard<std::mutex> lock(rcv_mtx);
+  return m_load_count;
+}
+
+std::string ListenerStats::print() const {
+  std::string result =
+      fmt::format("Listener: {} messages acked ({} timed out), {:.2f} MB sent\n", messages,
+                  timeouts, bytes_sent / (1024. * 1024.));
+  if (messages) {
+    result += fmt::format("  round trip: {:.3f} ms average, {:.3f} ms max\n", total_ms / messages,
+                          max_ms);
+    if (total_ms > 0) {
+      result += fmt::format("  throughput: {:.2f} MB/s\n",
+                            bytes_sent / (1024. * 1024.) / (total_ms / 1000.));
+    }
+  }
+  return result;
+}
+
 }  // namespace listener
@@ -12,6 +12,7 @@
 #include <vector>
 #include <thread>
 #include <mutex>
+#include <condition_variable>
 #include <unordered_map>
 #include "common/common_types.h"
 #include "common/listener_common.h"
@@ -21,6 +22,18 @@
 
 namespace listener {
 
+/*!
+ * Timing for messages sent to the target, measured from the start of the send until the ack.
+ */
+struct ListenerStats {
+  u64 messages = 0;     //! messages that were acked
+  u64 bytes_sent = 0;   //! total size of acked messages, including headers
+  u64 timeouts = 0;     //! messages we gave up waiting for
+  double total_ms = 0;  //! sum of round trip times of acked messages
+  double max_ms = 0;    //! slowest round trip
+  std::string print() const;
+};
+
 class Listener {
  public:
   static constexpr int BUFFER_SIZE = 32 * 1024 * 1024;
@@ -40,6 +53,9 @@ class Listener {
   void add_debugger(Debugger* debugger);
   bool most_recent_send_was_acked() const { return got_ack; }
   MemoryMap build_memory_map();
+  u64 get_load_count();
+  const ListenerStats& get_stats() const { return m_stats; }
+  void reset_stats() { m_stats = ListenerStats(); }
 
  private:
   void add_load(const std::string& name, const LoadEntry& le);
@@ -55,6 +71,9 @@ class Listener {
   int listen_socket = -1;               //! socket
   bool got_ack = false;
   bool waiting_for_ack = false;
+  std::mutex m_ack_mutex;
+  std::condition_variable m_ack_cv;  //! notified by the receive thread when an ack arrives
+  ListenerStats m_stats;
 
   Debugger* m_debugger = nullptr;
 
@@ -64,6 +83,7 @@ class Listener {
   ListenerMessageKind filter = ListenerMessageKind::MSG_INVALID;
   std::vector<std::string> message_record;
   std::unordered_map<std::string, LoadEntry> m_load_entries;
+  u64 m_load_count = 0;  //! incremented on each load, so users of the memory map know it changed
   char ack_recv_buff[512];
   uint64_t last_sent_id = 0;
   uint64_t last_recvd_id = 0;
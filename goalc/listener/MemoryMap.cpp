@@ -107,13 +107,18 @@ std::string MemoryMap::print() const {
   return result;
 }
 
+/*!
+ * Find the entry containing addr. The entries are sorted and have no gaps, so this is a binary
+ * search for the last entry starting at or before addr.
+ */
 const MemoryMapEntry& MemoryMap::lookup(u32 addr) {
-  for (auto& entry : m_entries) {
-    if (addr >= entry.start_addr && addr < entry.end_addr) {
-      return entry;
-    }
-  }
-  assert(false);
+  auto it = std::upper_bound(
+      m_entries.begin(), m_entries.end(), addr,
+      [](u32 a, const MemoryMapEntry& entry) { return a < entry.start_addr; });
+  assert(it != m_entries.begin());
+  --it;
+  assert(addr >= it->start_addr && addr < it->end_addr);
+  return *it;
 }
 
 bool MemoryMap::lookup(const std::string& obj_name, u8 seg_id, MemoryMapEntry* out) {
@@ -2,6 +2,7 @@
 #include "goalc/compiler/Compiler.h"
 #include "common/versions.h"
 #include "common/util/FileUtil.h"
+#include "common/util/Timer.h"
 #include "common/log/log.h"
 
 void setup_logging(bool verbose) {
@@ -38,7 +39,9 @@ int main(int argc, char** argv) {
 
   lg::info("OpenGOAL Compiler {}.{}", versions::GOAL_VERSION_MAJOR, versions::GOAL_VERSION_MINOR);
 
+  Timer startup_timer;
   Compiler compiler;
+  lg::info("Compiler ready in {:.2f} ms", startup_timer.getMs());
 
   if (argument.empty()) {
     compiler.execute_repl();
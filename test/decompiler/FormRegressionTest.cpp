@@ -13,14 +13,16 @@ using namespace decompiler;
 
 void FormRegressionTest::SetUpTestCase() {
   parser = std::make_unique<InstructionParser>();
-  dts = std::make_unique<DecompilerTypeSystem>();
-  dts->parse_type_defs({"decompiler", "config", "all-types.gc"});
+  // the type system is only read by the tests, so all test suites share one copy and all-types.gc
+  // is only parsed once.
+  if (!dts) {
+    dts = std::make_unique<DecompilerTypeSystem>();
+    dts->parse_type_defs({"decompiler", "config", "all-types.gc"});
+  }
 }
 
 void FormRegressionTest::TearDownTestCase() {
   parser.reset();
-  dts.reset();
-  parser.reset();
 }
 
 void FormRegressionTest::TestData::add_string_at_label(const std::string& label_name,
@@ -74,11 +76,6 @@ std::unique_ptr<FormRegressionTest::TestData> FormRegressionTest::make_function(
     const std::string& method_name,
     const std::vector<std::pair<std::string, std::string>>& strings,
     const std::unordered_map<int, std::vector<TypeHint>>& hints) {
-  dts->type_prop_settings.locked = true;
-  dts->type_prop_settings.reset();
-  dts->type_prop_settings.allow_pair = allow_pairs;
-  dts->type_prop_settings.current_method_type = method_name;
-
   std::vector<std::string> string_label_names;
   for (auto& x : strings) {
     string_label_names.push_back(x.first);
@@ -93,6 +90,10 @@ std::unique_ptr<FormRegressionTest::TestData> FormRegressionTest::make_function(
   test->func.instructions = program.instructions;
   test->func.guessed_name.set_as_global("test-function");
   test->func.type = function_type;
+  if (allow_pairs) {
+    test->func.ir2.env.set_sloppy_pair_typing();
+  }
+  test->func.ir2.env.set_method_type(method_name);
 
   for (auto& str : strings) {
     test->add_string_at_label(str.first, str.second);
@@ -0,0 +1,56 @@
+#include "gtest/gtest.h"
+#include "decompiler/analysis/reg_usage.h"
+
+using namespace decompiler;
+
+TEST(DecompilerRegSet, InsertAndIterate) {
+  RegSet set;
+  EXPECT_TRUE(set.empty());
+  set.insert(Register(Reg::FPR, 3));
+  set.insert(Register(Reg::GPR, Reg::RA));
+  set.insert(Register(Reg::GPR, Reg::V0));
+  set.insert(Register(Reg::PCR, 1));
+  set.insert(Register(Reg::GPR, Reg::V0));
+  EXPECT_EQ(set.size(), 4);
+  EXPECT_TRUE(set.contains(Register(Reg::GPR, Reg::RA)));
+  EXPECT_FALSE(set.contains(Register(Reg::GPR, Reg::A0)));
+
+  std::vector<Register> regs;
+  for (auto reg : set) {
+    regs.push_back(reg);
+  }
+  std::vector<Register> expected = {Register(Reg::GPR, Reg::V0), Register(Reg::GPR, Reg::RA),
+                                    Register(Reg::FPR, 3), Register(Reg::PCR, 1)};
+  EXPECT_EQ(regs, expected);
+
+  set.erase(Register(Reg::GPR, Reg::RA));
+  EXPECT_FALSE(set.contains(Register(Reg::GPR, Reg::RA)));
+  set.clear();
+  EXPECT_TRUE(set.empty());
+  EXPECT_TRUE(set.begin() == set.end());
+}
+
+TEST(DecompilerRegSet, SetOperations) {
+  RegSet a, b;
+  a.insert(Register(Reg::GPR, Reg::A0));
+  a.insert(Register(Reg::GPR, Reg::A1));
+  b.insert(Register(Reg::GPR, Reg::A1));
+  b.insert(Register(Reg::VF, 12));
+  EXPECT_TRUE(a.intersects(b));
+  EXPECT_TRUE(a != b);
+
+  RegSet u = a;
+  u |= b;
+  EXPECT_EQ(u.size(), 3);
+
+  RegSet i = a;
+  i &= b;
+  EXPECT_EQ(i.size(), 1);
+  EXPECT_TRUE(i.contains(Register(Reg::GPR, Reg::A1)));
+
+  RegSet d = a;
+  d -= b;
+  EXPECT_EQ(d.size(), 1);
+  EXPECT_TRUE(d.contains(Register(Reg::GPR, Reg::A0)));
+  EXPECT_FALSE(d.intersects(b));
+}
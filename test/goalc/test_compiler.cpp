@@ -5,7 +5,47 @@
 #include "game/runtime.h"
 #include "goalc/listener/Listener.h"
 #include "goalc/compiler/Compiler.h"
+#include "goalc/compiler/CodeGenerator.h"
 
 TEST(CompilerAndRuntime, ConstructCompiler) {
   Compiler compiler;
-}
\ No newline at end of file
+}
+
+TEST(CodeGenerator, SharedStaticData) {
+  GlobalEnv genv;
+  auto fe = genv.add_file("shared-statics");
+  std::vector<StaticObject*> objs;
+  auto add = [&](std::unique_ptr<StaticObject> obj) {
+    objs.push_back(obj.get());
+    fe->add_static(std::move(obj));
+  };
+  add(std::make_unique<StaticFloat>(1.f, MAIN_SEGMENT));
+  add(std::make_unique<StaticFloat>(1.f, MAIN_SEGMENT));
+  add(std::make_unique<StaticFloat>(0.f, MAIN_SEGMENT));
+  add(std::make_unique<StaticFloat>(-0.f, MAIN_SEGMENT));
+  add(std::make_unique<StaticString>("abc", MAIN_SEGMENT));
+  add(std::make_unique<StaticString>("abc", MAIN_SEGMENT));
+  add(std::make_unique<StaticString>("abc", DEBUG_SEGMENT));
+  add(std::make_unique<StaticStructure>(MAIN_SEGMENT));
+  add(std::make_unique<StaticStructure>(MAIN_SEGMENT));
+
+  TypeSystem ts;
+  ts.add_builtin_types();
+  DebugInfo debug_info("shared-statics");
+  CodeGenerator gen(fe, &debug_info);
+  gen.run(&ts);
+
+  auto same = [&](int a, int b) {
+    return objs.at(a)->rec.seg == objs.at(b)->rec.seg &&
+           objs.at(a)->rec.static_id == objs.at(b)->rec.static_id;
+  };
+  EXPECT_TRUE(same(0, 1));
+  EXPECT_FALSE(same(0, 2));
+  EXPECT_FALSE(same(2, 3));
+  EXPECT_TRUE(same(4, 5));
+  EXPECT_FALSE(same(4, 6));
+  // structures may be modified, so they are never shared.
+  EXPECT_FALSE(same(7, 8));
+  // one float, and a string with a type, size, 3 chars and a null.
+  EXPECT_EQ(gen.static_bytes_saved(), 4 + 12);
+}
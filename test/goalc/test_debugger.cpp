@@ -47,6 +47,34 @@ TEST(Debugger, DebuggerBreakAndContinue) {
   }
 }
 
+TEST(Debugger, WatcherSeesStops) {
+  Compiler compiler;
+  // evidently you can't ptrace threads in your own process, so we need to run the runtime in a
+  // separate process.
+  if (!fork()) {
+    GoalTest::runtime_no_kernel();
+    exit(0);
+  } else {
+    compiler.connect_to_target();
+    compiler.poke_target();
+    compiler.run_test_from_string("(dbg)");
+    auto& debugger = compiler.get_debugger();
+
+    // the watcher should see each stop without the debugger asking for it.
+    for (int i = 0; i < 50; i++) {
+      EXPECT_TRUE(debugger.do_continue());
+      EXPECT_TRUE(xdbg::break_now(debugger.get_thread_id()));
+      while (!debugger.is_halted()) {
+        std::this_thread::yield();
+      }
+    }
+    compiler.shutdown_target();
+
+    // and now the child process should be done!
+    EXPECT_TRUE(wait(nullptr) >= 0);
+  }
+}
+
 TEST(Debugger, DebuggerReadMemory) {
   Compiler compiler;
   // evidently you can't ptrace threads in your own process, so we need to run the runtime in a
@@ -261,7 +261,7 @@ TEST_F(WithGameTests, NewStaticBasic) {
 
 TEST_F(WithGameTests, VectorDot) {
   runner.run_static_test(env, testCategory, "test-vector-dot.gc",
-                         get_test_pass_string("vector-dot", 1));
+                         get_test_pass_string("vector-dot", 2));
 }
 
 TEST_F(WithGameTests, DebuggerMemoryMap) {
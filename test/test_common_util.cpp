@@ -1,5 +1,8 @@
 #include "common/util/FileUtil.h"
+#include "common/util/DgoWriter.h"
 #include "gtest/gtest.h"
+#include <cstring>
+#include <filesystem>
 #include <string>
 #include <vector>
 
@@ -10,3 +13,78 @@ TEST(FileUtil, valid_path) {
 
   EXPECT_TRUE(true);
 }
+
+TEST(DgoWriter, BuildAndSkipUnchanged) {
+  auto obj_dir = file_util::get_file_path({"out", "obj"});
+  auto manifest = file_util::get_file_path({"out", "iso", "dgo-manifest.txt"});
+  auto dgo_path = file_util::get_file_path({"out", "iso", "TEST-WRITER.DGO"});
+  file_util::create_dir_if_needed(obj_dir);
+
+  // don't lose the hashes of real DGOs.
+  bool had_manifest = std::filesystem::exists(manifest);
+  std::string old_manifest = had_manifest ? file_util::read_text_file(manifest) : "";
+
+  std::vector<uint8_t> a = {1, 2, 3};
+  std::vector<uint8_t> b(20, 0xab);
+  auto a_path = file_util::get_file_path({"out", "obj", "test-writer-a.o"});
+  auto b_path = file_util::get_file_path({"out", "obj", "test-writer-b.o"});
+  file_util::write_binary_file(a_path, a.data(), a.size());
+  file_util::write_binary_file(b_path, b.data(), b.size());
+
+  DgoDescription desc;
+  desc.dgo_name = "TEST-WRITER.DGO";
+  desc.entries.push_back({"test-writer-a.o", "a"});
+  desc.entries.push_back({"test-writer-b.o", "b-in-dgo"});
+  build_dgos({desc});
+
+  // 64 byte header, then each object gets a 64 byte header and is padded to 16 bytes.
+  auto dgo = file_util::read_binary_file(dgo_path);
+  ASSERT_EQ(dgo.size(), 64u + 64 + 16 + 64 + 32);
+  uint32_t u32_val;
+  memcpy(&u32_val, dgo.data(), 4);
+  EXPECT_EQ(u32_val, 2u);
+  EXPECT_STREQ((const char*)dgo.data() + 4, "TEST-WRITER.DGO");
+  memcpy(&u32_val, dgo.data() + 64, 4);
+  EXPECT_EQ(u32_val, 3u);
+  EXPECT_STREQ((const char*)dgo.data() + 64 + 4, "a");
+  EXPECT_EQ(0, memcmp(dgo.data() + 128, a.data(), a.size()));
+  for (size_t i = 128 + a.size(); i < 144; i++) {
+    EXPECT_EQ(dgo.at(i), 0);
+  }
+  memcpy(&u32_val, dgo.data() + 144, 4);
+  EXPECT_EQ(u32_val, 20u);
+  EXPECT_STREQ((const char*)dgo.data() + 144 + 4, "b-in-dgo");
+  EXPECT_EQ(0, memcmp(dgo.data() + 208, b.data(), b.size()));
+  for (size_t i = 208 + b.size(); i < dgo.size(); i++) {
+    EXPECT_EQ(dgo.at(i), 0);
+  }
+
+  // nothing changed, so the DGO shouldn't be written again.
+  auto marked = dgo;
+  marked.at(0) = 0xff;
+  file_util::write_binary_file(dgo_path, marked.data(), marked.size());
+  build_dgos({desc});
+  EXPECT_EQ(file_util::read_binary_file(dgo_path), marked);
+
+  // but it should once an object changes.
+  a.at(0) = 7;
+  file_util::write_binary_file(a_path, a.data(), a.size());
+  build_dgos({desc});
+  auto rebuilt = file_util::read_binary_file(dgo_path);
+  ASSERT_EQ(rebuilt.size(), dgo.size());
+  EXPECT_EQ(rebuilt.at(0), 2);
+  EXPECT_EQ(rebuilt.at(128), 7);
+
+  std::filesystem::remove(a_path);
+  std::filesystem::remove(b_path);
+  std::filesystem::remove(dgo_path);
+  if (had_manifest) {
+    // write_text_file adds a newline.
+    if (!old_manifest.empty() && old_manifest.back() == '\n') {
+      old_manifest.pop_back();
+    }
+    file_util::write_text_file(manifest, old_manifest);
+  } else {
+    std::filesystem::remove(manifest);
+  }
+}
@@ -364,6 +364,62 @@ TEST(EmitterIntegerMath, xor_gpr64_gpr64) {
   }
 }
 
+TEST(EmitterIntegerMath, logic_gpr64_imm) {
+  CodeTester tester;
+  tester.init_code_buffer(256);
+  std::vector<s64> vals = {0, 1, -2, INT32_MIN, INT32_MAX, INT64_MIN, INT64_MAX, 117, -348473};
+  std::vector<s64> imms = {0, 1, -1, INT8_MIN, INT8_MAX, INT32_MIN, INT32_MAX, 0x12345};
+  for (int i = 0; i < 16; i++) {
+    if (i == RSP) {
+      continue;
+    }
+    for (auto v : vals) {
+      for (auto imm : imms) {
+        tester.clear();
+        tester.emit_push_all_gprs(true);
+        tester.emit(IGen::mov_gpr64_u64(i, v));
+        tester.emit(IGen::and_gpr64_imm(i, imm));
+        tester.emit(IGen::mov_gpr64_gpr64(RAX, i));
+        tester.emit_pop_all_gprs(true);
+        tester.emit_return();
+        EXPECT_EQ(tester.execute_ret<s64>(0, 0, 0, 0), v & imm);
+
+        tester.clear();
+        tester.emit_push_all_gprs(true);
+        tester.emit(IGen::mov_gpr64_u64(i, v));
+        tester.emit(IGen::or_gpr64_imm(i, imm));
+        tester.emit(IGen::mov_gpr64_gpr64(RAX, i));
+        tester.emit_pop_all_gprs(true);
+        tester.emit_return();
+        EXPECT_EQ(tester.execute_ret<s64>(0, 0, 0, 0), v | imm);
+
+        tester.clear();
+        tester.emit_push_all_gprs(true);
+        tester.emit(IGen::mov_gpr64_u64(i, v));
+        tester.emit(IGen::xor_gpr64_imm(i, imm));
+        tester.emit(IGen::mov_gpr64_gpr64(RAX, i));
+        tester.emit_pop_all_gprs(true);
+        tester.emit_return();
+        EXPECT_EQ(tester.execute_ret<s64>(0, 0, 0, 0), v ^ imm);
+      }
+    }
+  }
+
+  tester.clear();
+  tester.emit(IGen::and_gpr64_imm(RBX, 3));
+  tester.emit(IGen::and_gpr64_imm(R13, -2));
+  tester.emit(IGen::and_gpr64_imm(RBX, 0x12345));
+  tester.emit(IGen::or_gpr64_imm(RBX, 3));
+  tester.emit(IGen::or_gpr64_imm(R13, -2));
+  tester.emit(IGen::or_gpr64_imm(R13, 0x12345));
+  tester.emit(IGen::xor_gpr64_imm(RBX, 3));
+  tester.emit(IGen::xor_gpr64_imm(R13, -2));
+  tester.emit(IGen::xor_gpr64_imm(RBX, -0x12345));
+  EXPECT_EQ(tester.dump_to_hex_string(true),
+            "4883E3034983E5FE4881E3452301004883CB034983CDFE4981CD452301004883F3034983F5FE4881F3BB"
+            "DCFEFF");
+}
+
 TEST(EmitterIntegerMath, not_gpr64) {
   CodeTester tester;
   tester.init_code_buffer(256);
@@ -281,6 +281,23 @@ TEST(EmitterAVX, BlendVF) {
             "43110CED03");
 }
 
+TEST(EmitterAVX, DotVF) {
+  CodeTester tester;
+  tester.init_code_buffer(1024);
+  tester.emit(IGen::dot_vf(XMM0 + 3, XMM0 + 3, XMM0 + 3, 0b111));
+  tester.emit(IGen::dot_vf(XMM0 + 3, XMM0 + 3, XMM0 + 13, 0b111));
+  tester.emit(IGen::dot_vf(XMM0 + 3, XMM0 + 13, XMM0 + 3, 0b111));
+  tester.emit(IGen::dot_vf(XMM0 + 3, XMM0 + 13, XMM0 + 13, 0b111));
+  tester.emit(IGen::dot_vf(XMM0 + 13, XMM0 + 3, XMM0 + 3, 0b111));
+  tester.emit(IGen::dot_vf(XMM0 + 13, XMM0 + 3, XMM0 + 13, 0b111));
+  tester.emit(IGen::dot_vf(XMM0 + 13, XMM0 + 13, XMM0 + 3, 0b111));
+  tester.emit(IGen::dot_vf(XMM0 + 13, XMM0 + 13, XMM0 + 13, 0b111));
+
+  EXPECT_EQ(tester.dump_to_hex_string(true),
+            "C4E36140DB7FC4C36140DD7FC4E31140DB7FC4C31140DD7FC4636140EB7FC4436140ED7FC4631140EB7FC4"
+            "431140ED7F");
+}
+
 TEST(EmitterAVX, RIP) {
   CodeTester tester;
   tester.init_code_buffer(1024);
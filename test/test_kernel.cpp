@@ -9,6 +9,7 @@
 #include "game/kernel/kprint.h"
 #include "game/kernel/kdsnetm.h"
 #include "game/kernel/kscheme.h"
+#include "game/kernel/kmalloc.h"
 #include "all_jak1_symbols.h"
 
 TEST(Kernel, strend) {
@@ -292,6 +293,7 @@ void setup_hack_heaps(void* mem, int size) {
   MasterDebug = 1;
   EXPECT_TRUE(heap_size > 8 * 1024 * 1024);
   kmalloc_init_globals();
+  kscheme_init_globals();
   kprint_init_globals();
 
   kinitheap(kglobalheap, Ptr<u8>(HEAP_START), heap_size);
@@ -342,6 +344,110 @@ TEST(Kernel, PrintBuffer) {
   // more complicated tests for format will be done from within GOAL.
 }
 
+TEST(Kernel, KmallocProfile) {
+  constexpr int size = 32 * 1024 * 1024;
+  auto mem = new u8[size];
+  setup_hack_heaps(mem, size);
+
+  // nothing is recorded until profiling is turned on.
+  kmalloc(kglobalheap, 0x100, 0, "before-enable");
+  kmalloc_profile_enable(s7.offset + FIX_SYM_TRUE);
+  EXPECT_TRUE(kmalloc_profile_enabled);
+  kmalloc(kglobalheap, 0x100, 0, "thing-a");
+  kmalloc(kglobalheap, 0x100, 0, "thing-a");
+  kmalloc(kglobalheap, 0x4000, KMALLOC_TOP, "thing-b");
+  kmalloc(kdebugheap, 0x40, 0, "thing-c");
+  kmalloc_profile_enable(s7.offset + FIX_SYM_FALSE);
+  EXPECT_FALSE(kmalloc_profile_enabled);
+  kmalloc(kglobalheap, 0x100, 0, "after-disable");
+
+  clear_print();
+  kmalloc_profile_print(8);
+  std::string result = PrintBufArea.cast<char>().c() + sizeof(ListenerMessageHeader);
+  EXPECT_NE(result.find("kmalloc profile for heap global"), std::string::npos);
+  EXPECT_NE(result.find("kmalloc profile for heap debug"), std::string::npos);
+  EXPECT_NE(result.find("thing-a                                   512        2            0"),
+            std::string::npos);
+  EXPECT_NE(result.find("thing-b                                     0        0        16384"),
+            std::string::npos);
+  EXPECT_NE(result.find("thing-c"), std::string::npos);
+  EXPECT_EQ(result.find("before-enable"), std::string::npos);
+  EXPECT_EQ(result.find("after-disable"), std::string::npos);
+
+  kmalloc_profile_reset();
+  clear_print();
+  kmalloc_profile_print(8);
+  result = PrintBufArea.cast<char>().c() + sizeof(ListenerMessageHeader);
+  EXPECT_TRUE(result.empty());
+
+  delete[] mem;
+}
+
+namespace {
+bool is_zero(Ptr<u8> mem, int size) {
+  for (int i = 0; i < size; i++) {
+    if (mem.c()[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+}  // namespace
+
+TEST(Kernel, KmallocClearsReusedMemory) {
+  constexpr int size = 32 * 1024 * 1024;
+  auto mem = new u8[size];
+  setup_hack_heaps(mem, size);
+
+  // fresh memory from kinitheap is zero
+  auto a = kmalloc(kglobalheap, 0x1000, KMALLOC_MEMSET, "a");
+  EXPECT_TRUE(is_zero(a, 0x1000));
+
+  // reset the heap, and use the memory again.
+  memset(a.c(), 0xff, 0x1000);
+  kglobalheap->current = a;
+  auto b = kmalloc(kglobalheap, 0x2000, KMALLOC_MEMSET, "b");
+  EXPECT_EQ(a.offset, b.offset);
+  EXPECT_TRUE(is_zero(b, 0x2000));
+
+  // top allocations, then move top back up, like the dgo loader does.
+  auto old_top = kglobalheap->top;
+  auto c = kmalloc(kglobalheap, 0x1000, KMALLOC_TOP, "c");
+  memset(c.c(), 0xff, 0x1000);
+  kglobalheap->top = old_top;
+  auto d = kmalloc(kglobalheap, 0x1000, KMALLOC_TOP | KMALLOC_MEMSET, "d");
+  EXPECT_EQ(c.offset, d.offset);
+  EXPECT_TRUE(is_zero(d, 0x1000));
+
+  // write past current, then move current up, like the linker does.
+  auto cur = kglobalheap->current;
+  memset(cur.c(), 0xff, 0x4000);
+  kglobalheap->current = cur + 0x1000;
+  auto e = kmalloc(kglobalheap, 0x2000, KMALLOC_MEMSET, "e");
+  EXPECT_TRUE(is_zero(e, 0x2000));
+
+  delete[] mem;
+}
+
+TEST(Kernel, KmallocClearsDataLoadedAboveCurrent) {
+  constexpr int size = 32 * 1024 * 1024;
+  auto mem = new u8[size];
+  setup_hack_heaps(mem, size);
+
+  // load data above current without moving it, like the last object of a DGO.
+  auto cur = kglobalheap->current;
+  memset(cur.c(), 0xff, 0x4000);
+  kmalloc_forget_zero_range(kglobalheap);
+
+  // the linker allocates part of it without clearing, and the rest is left in free memory.
+  auto a = kmalloc(kglobalheap, 0x1000, 0, "a");
+  EXPECT_EQ(a.offset, cur.offset);
+  auto b = kmalloc(kglobalheap, 0x2000, KMALLOC_MEMSET, "b");
+  EXPECT_TRUE(is_zero(b, 0x2000));
+
+  delete[] mem;
+}
+
 TEST(Kernel, HashTable) {
   constexpr int size = 32 * 1024 * 1024;
   auto mem = new u8[size];
@@ -385,3 +491,58 @@ TEST(Kernel, HashTable) {
 
   delete[] mem;
 }
+
+TEST(Kernel, MethodSetUpdatesChildren) {
+  constexpr int size = 32 * 1024 * 1024;
+  auto mem = new u8[size];
+  setup_hack_heaps(mem, size);
+  auto enable_method_set = intern_from_c("*enable-method-set*");
+  enable_method_set->value = 1;
+  EnableMethodSet = enable_method_set.cast<u32>();
+
+  // parent <- child <- grandchild, parent <- other-child, and an unrelated type.
+  u64 flags = u64(12) << 32;
+  auto parent = intern_type_from_c("parent", 12);
+  auto child = intern_type_from_c("child", 12);
+  auto grandchild = intern_type_from_c("grandchild", 12);
+  auto other_child = intern_type_from_c("other-child", 12);
+  auto unrelated = intern_type_from_c("unrelated", 12);
+  set_type_values(child, parent, flags);
+  set_type_values(grandchild, child, flags);
+  set_type_values(other_child, parent, flags);
+  // other-child starts out under the unrelated type, then moves.
+  set_type_values(other_child, unrelated, flags);
+  set_type_values(other_child, parent, flags);
+
+  // everybody inherits method 9 from parent.
+  for (auto type : {parent, child, grandchild, other_child, unrelated}) {
+    type->get_method(9).offset = 0x1000;
+  }
+  // child overrides method 10, so grandchild gets its version.
+  parent->get_method(10).offset = 0x2000;
+  other_child->get_method(10).offset = 0x2000;
+  child->get_method(10).offset = 0x3000;
+  grandchild->get_method(10).offset = 0x3000;
+
+  EXPECT_EQ(method_set(parent.offset, 9, 0x4000), 0x4000u);
+  EXPECT_EQ(parent->get_method(9).offset, 0x4000u);
+  EXPECT_EQ(child->get_method(9).offset, 0x4000u);
+  EXPECT_EQ(grandchild->get_method(9).offset, 0x4000u);
+  EXPECT_EQ(other_child->get_method(9).offset, 0x4000u);
+  EXPECT_EQ(unrelated->get_method(9).offset, 0x1000u);
+
+  method_set(parent.offset, 10, 0x5000);
+  EXPECT_EQ(parent->get_method(10).offset, 0x5000u);
+  EXPECT_EQ(child->get_method(10).offset, 0x3000u);
+  EXPECT_EQ(grandchild->get_method(10).offset, 0x3000u);
+  EXPECT_EQ(other_child->get_method(10).offset, 0x5000u);
+
+  // with method set disabled, only the type itself changes.
+  enable_method_set->value = 0;
+  MasterDebug = 0;
+  method_set(parent.offset, 9, 0x6000);
+  EXPECT_EQ(parent->get_method(9).offset, 0x6000u);
+  EXPECT_EQ(child->get_method(9).offset, 0x4000u);
+
+  delete[] mem;
+}
@@ -0,0 +1,80 @@
+#include "gtest/gtest.h"
+#include "common/link_types.h"
+#include "goalc/debugger/DebugInfo.h"
+#include "goalc/listener/MemoryMap.h"
+
+using namespace listener;
+
+TEST(MemoryMap, LookupAddress) {
+  std::unordered_map<std::string, LoadEntry> loads;
+  LoadEntry a;
+  a.segments[MAIN_SEGMENT] = 0x1000;
+  a.segment_sizes[MAIN_SEGMENT] = 0x100;
+  a.segments[DEBUG_SEGMENT] = 0x5000;
+  a.segment_sizes[DEBUG_SEGMENT] = 0x18;  // rounded up to 0x20
+  loads["a"] = a;
+  LoadEntry b;
+  b.segments[MAIN_SEGMENT] = 0x1100;
+  b.segment_sizes[MAIN_SEGMENT] = 0x200;
+  loads["b"] = b;
+
+  MemoryMap map(loads);
+  EXPECT_TRUE(map.lookup(0).empty);
+  EXPECT_TRUE(map.lookup(0xfff).empty);
+  EXPECT_EQ(map.lookup(0x1000).obj_name, "a");
+  EXPECT_EQ(map.lookup(0x10ff).obj_name, "a");
+  EXPECT_EQ(map.lookup(0x1100).obj_name, "b");
+  EXPECT_EQ(map.lookup(0x12ff).obj_name, "b");
+  EXPECT_TRUE(map.lookup(0x1300).empty);
+  EXPECT_EQ(map.lookup(0x501f).obj_name, "a");
+  EXPECT_EQ(map.lookup(0x501f).seg_id, DEBUG_SEGMENT);
+  EXPECT_TRUE(map.lookup(0x5020).empty);
+  EXPECT_TRUE(map.lookup(UINT32_MAX - 1).empty);
+
+  MemoryMapEntry entry;
+  EXPECT_TRUE(map.lookup("b", MAIN_SEGMENT, &entry));
+  EXPECT_EQ(entry.start_addr, 0x1100u);
+  EXPECT_FALSE(map.lookup("b", DEBUG_SEGMENT, &entry));
+}
+
+TEST(MemoryMap, LookupFunction) {
+  DebugInfo info("test-obj");
+  auto& f1 = info.add_function("f1");
+  auto& f2 = info.add_function("f2");
+  auto& f3 = info.add_function("f3");
+  // offsets are set after adding the functions, like the compiler does.
+  f1.seg = MAIN_SEGMENT;
+  f1.offset_in_seg = 0x20;
+  f1.length = 0x10;
+  f2.seg = MAIN_SEGMENT;
+  f2.offset_in_seg = 0x40;
+  f2.length = 0x30;
+  f3.seg = DEBUG_SEGMENT;
+  f3.offset_in_seg = 0x20;
+  f3.length = 0x10;
+
+  FunctionDebugInfo* result = nullptr;
+  std::string name;
+  EXPECT_FALSE(info.lookup_function(&result, &name, 0x1f, MAIN_SEGMENT));
+  EXPECT_TRUE(info.lookup_function(&result, &name, 0x20, MAIN_SEGMENT));
+  EXPECT_EQ(name, "f1");
+  EXPECT_EQ(result, &f1);
+  EXPECT_TRUE(info.lookup_function(&result, &name, 0x2f, MAIN_SEGMENT));
+  EXPECT_EQ(name, "f1");
+  EXPECT_FALSE(info.lookup_function(&result, &name, 0x30, MAIN_SEGMENT));
+  EXPECT_TRUE(info.lookup_function(&result, &name, 0x6f, MAIN_SEGMENT));
+  EXPECT_EQ(name, "f2");
+  EXPECT_FALSE(info.lookup_function(&result, &name, 0x70, MAIN_SEGMENT));
+  EXPECT_TRUE(info.lookup_function(&result, &name, 0x25, DEBUG_SEGMENT));
+  EXPECT_EQ(name, "f3");
+  EXPECT_FALSE(info.lookup_function(&result, &name, 0x40, DEBUG_SEGMENT));
+
+  // adding a function after a lookup should still find it.
+  auto& f4 = info.add_function("f4");
+  f4.seg = MAIN_SEGMENT;
+  f4.offset_in_seg = 0x30;
+  f4.length = 0x10;
+  EXPECT_TRUE(info.lookup_function(&result, &name, 0x30, MAIN_SEGMENT));
+  EXPECT_EQ(name, "f4");
+  EXPECT_EQ(result, &f4);
+}
@@ -0,0 +1,85 @@
+#ifdef __linux__
+#include <csignal>
+#endif
+
+#include "gtest/gtest.h"
+#include "common/util/Timer.h"
+#include "game/system/sampling_profiler.h"
+#include "goalc/debugger/ProfileReport.h"
+
+TEST(Profiler, ReportFlatAndFolded) {
+  ProfileReport report;
+  report.add_sample({"main", "update", "draw"}, "(set! a b)");
+  report.add_sample({"main", "update", "draw"}, "(set! a b)");
+  report.add_sample({"main", "update"}, "");
+  report.add_sample({"main", "[runtime]"}, "");
+
+  EXPECT_EQ(report.sample_count(), 4);
+  EXPECT_EQ(report.print_folded(),
+            "main;[runtime] 1\n"
+            "main;update 1\n"
+            "main;update;draw 2\n");
+  EXPECT_EQ(report.print_flat(3),
+            "  self%  total%  function (4 samples)\n"
+            " 50.00%  50.00%  draw\n"
+            " 25.00%  75.00%  update\n"
+            " 25.00%  25.00%  [runtime]\n");
+  EXPECT_EQ(report.print_ir(10),
+            "  self%  ir\n"
+            " 50.00%  draw: (set! a b)\n");
+  EXPECT_EQ(report.print_tree(30.),
+            "100.00% all\n"
+            "100.00%   main\n"
+            " 75.00%     update\n"
+            " 50.00%       draw\n");
+}
+
+TEST(Profiler, ReportRecursionCountedOnce) {
+  ProfileReport report;
+  report.add_sample({"fib", "fib", "fib"}, "");
+  EXPECT_EQ(report.print_flat(10),
+            "  self%  total%  function (1 samples)\n"
+            "100.00% 100.00%  fib\n");
+}
+
+#ifdef __linux__
+TEST(Profiler, SamplesThisThread) {
+  ASSERT_TRUE(sampling_profiler_start(1000));
+  EXPECT_TRUE(sampling_profiler_running());
+  // samples are taken on the profiler's signal stack, not the stack of the interrupted code.
+  stack_t signal_stack;
+  ASSERT_EQ(sigaltstack(nullptr, &signal_stack), 0);
+  EXPECT_FALSE(signal_stack.ss_flags & SS_DISABLE);
+
+  // keep the thread busy so there is something to sample.
+  Timer timer;
+  volatile u64 counter = 0;
+  while (timer.getMs() < 100) {
+    counter = counter + 1;
+  }
+  sampling_profiler_stop();
+  EXPECT_FALSE(sampling_profiler_running());
+  ASSERT_EQ(sigaltstack(nullptr, &signal_stack), 0);
+  EXPECT_TRUE(signal_stack.ss_flags & SS_DISABLE);
+
+  auto* buffer = sampling_profiler_buffer();
+  ASSERT_TRUE(buffer);
+  EXPECT_EQ(buffer->magic, PROFILER_MAGIC);
+  EXPECT_EQ(buffer->hz, 0u);
+  u64 count = buffer->write_count.load();
+  // should be 100, but leave room for a busy machine.
+  EXPECT_GT(count, 10u);
+  EXPECT_LE(count, PROFILER_SAMPLE_COUNT);
+  for (u64 i = 0; i < count; i++) {
+    // we're on a normal thread stack, so each sample should have some of it.
+    EXPECT_GT(buffer->samples[i].stack_words, 0u);
+    EXPECT_NE(buffer->samples[i].rip, 0u);
+  }
+
+  // no more samples once stopped.
+  Timer wait;
+  while (wait.getMs() < 20) {
+  }
+  EXPECT_EQ(buffer->write_count.load(), count);
+}
+#endif
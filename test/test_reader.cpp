@@ -195,13 +195,19 @@ TEST(GoosReader, StringWithNumberEscapes) {
 
 TEST(GoosReader, Symbol) {
   std::vector<std::string> test_symbols = {
-      "test", "test-two", "__werid-sym__", "-a", "-", "/", "*", "+", "a", "#f"};
+      "test", "test-two", "__werid-sym__", "-a", "-", "/", "*", "+", "a", "#f", "1.2.3", "-.",
+      "1-2"};
 
   Reader reader;
 
   for (const auto& sym : test_symbols) {
     EXPECT_TRUE(check_first_symbol(reader.read_from_string(sym), sym));
   }
+
+  // the same symbol should be the same object, even when read from different text.
+  auto a = reader.read_from_string("test-two").as_pair()->cdr.as_pair()->car;
+  auto b = reader.read_from_string("(test-two)").as_pair()->cdr.as_pair()->car.as_pair()->car;
+  EXPECT_EQ(a.as_symbol(), b.as_symbol());
 }
 
 namespace {
@@ -354,3 +360,27 @@ TEST(GoosReader, TextDb) {
                          ", line: 5\n(1 2 3 4)\n";
   EXPECT_EQ(expected, reader.db.get_info_for(result));
 }
+
+TEST(GoosReader, TextDbLines) {
+  Reader reader;
+  auto result = reader.read_from_string("(a)\n\n  (b c)\n(d)", false);
+  auto b = result.as_pair()->cdr.as_pair()->car;
+  auto d = result.as_pair()->cdr.as_pair()->cdr.as_pair()->car;
+  EXPECT_EQ("text from Program string, line: 3\n  (b c)\n", reader.db.get_info_for(b));
+  EXPECT_EQ("text from Program string, line: 4\n(d)\n", reader.db.get_info_for(d));
+
+  // pairs that weren't read don't have a location.
+  EXPECT_EQ("?\n", reader.db.get_info_for(PairObject::make_new(b, d)));
+}
+
+TEST(GoosReader, TextDbFreesText) {
+  Reader reader;
+  std::weak_ptr<SourceText> text;
+  {
+    auto result = reader.read_from_string("(a)\n(b c)", false);
+    text = result.as_pair()->source;
+    EXPECT_FALSE(text.expired());
+  }
+  // nothing read from the text is left, so it shouldn't be kept.
+  EXPECT_TRUE(text.expired());
+}